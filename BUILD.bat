@@ -1,6 +1,15 @@
 @echo off
 echo Building Question Paper Generator...
-g++ -std=c++14 -Wall -Wextra -Iinclude -o question_generator.exe src\main.cpp src\file_manager.cpp src\preprocessor.cpp src\keyword_extractor.cpp src\line_scorer.cpp src\question_generator.cpp src\paper_exporter.cpp src\ui.cpp
+g++ -std=c++17 -Wall -Wextra -pthread -Iinclude -o question_generator.exe src\main.cpp src\file_manager.cpp src\file_buffer.cpp src\preprocessor.cpp src\keyword_extractor.cpp src\line_scorer.cpp src\question_generator.cpp src\paper_exporter.cpp src\ui.cpp src\parallel.cpp src\options.cpp src\corpus_manifest.cpp src\stream_pipeline.cpp src\corpus_pack.cpp src\simd.cpp src\vocabulary.cpp src\stopword_table.cpp src\corpus.cpp src\keyphrase_extractor.cpp src\keyword_sketch.cpp src\text_ranker.cpp
+
+if %ERRORLEVEL% NEQ 0 (
+    echo Build failed!
+    pause
+    exit /b 1
+)
+
+echo Building corpus packing tool...
+g++ -std=c++17 -Wall -Wextra -pthread -Iinclude -o pack_corpus.exe tools\pack_corpus.cpp src\file_manager.cpp src\file_buffer.cpp src\corpus_pack.cpp src\corpus_manifest.cpp src\parallel.cpp src\corpus.cpp
 
 if %ERRORLEVEL% EQU 0 (
     echo Build successful!
@@ -0,0 +1,78 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// Objective :- Thread-safe FIFO queue with a fixed capacity, used to connect pipeline stages running on different threads
+// Input :- None (class template declaration)
+// Output :- None (class template declaration)
+// Sideeffect :- None
+template <typename T>
+class BoundedQueue {
+public:
+    // Objective :- Initialize an empty queue that holds at most 'capacity' items
+    // Input :- capacity - maximum number of queued items (at least 1)
+    // Output :- None (constructor)
+    // Sideeffect :- Stores capacity
+    // Assumption :- capacity > 0
+    explicit BoundedQueue(std::size_t capacity) : capacity(capacity ? capacity : 1) {}
+
+    // Objective :- Append an item, waiting while the queue is full
+    // Input :- item - value to enqueue
+    // Output :- Returns false if the queue was closed (item is dropped), true otherwise
+    // Sideeffect :- Blocks the caller while the queue is full, wakes one waiting consumer
+    // Assumption :- None
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Wait for room or for the queue to be closed
+        notFull.wait(lock, [&] { return items.size() < capacity || closed; });
+        if (closed)
+            return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Objective :- Remove the oldest item, waiting while the queue is empty and still open
+    // Input :- out - reference receiving the dequeued item
+    // Output :- Returns false once the queue is closed and drained, true if an item was dequeued
+    // Sideeffect :- Blocks the caller while the queue is empty, wakes one waiting producer
+    // Assumption :- None
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Wait for an item or for the queue to be closed
+        notEmpty.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty())
+            return false;
+        out = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // Objective :- Close the queue: producers stop, consumers drain remaining items and then stop
+    // Input :- None
+    // Output :- None (void function)
+    // Sideeffect :- Wakes all waiting producers and consumers
+    // Assumption :- None
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+private:
+    std::size_t capacity;                // Maximum number of queued items
+    std::deque<T> items;                 // Queued items in FIFO order
+    bool closed = false;                 // True once close() was called
+    std::mutex mutex;                    // Guards items and closed
+    std::condition_variable notEmpty;    // Signalled when an item is added or the queue closes
+    std::condition_variable notFull;     // Signalled when an item is removed or the queue closes
+};
+
+#endif
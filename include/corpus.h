@@ -0,0 +1,150 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include "document.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Objective :- Build a view of a ProcessedLine so owned lines can be used wherever arena lines are expected
+// Input :- line - processed line to view
+// Output :- Returns LineView pointing into line
+// Sideeffect :- None
+// Assumption :- line outlives the view and is not modified while the view is used
+LineView viewOf(const ProcessedLine& line);
+
+// Objective :- Class storing all processed lines of one document in two arenas (text and token IDs) with per-line offset columns (struct-of-arrays), so a document costs a handful of allocations and is freed in one shot
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class DocumentArena {
+public:
+    // Objective :- Create an empty arena
+    // Input :- None
+    // Output :- None (constructor)
+    // Sideeffect :- None
+    // Assumption :- None
+    DocumentArena() = default;
+
+    // Objective :- Create an arena holding copies of the given lines, in order
+    // Input :- lines - processed lines to store (released by the caller afterwards)
+    // Output :- None (constructor)
+    // Sideeffect :- Sizes the arenas once and copies text and token IDs into them
+    // Assumption :- None
+    explicit DocumentArena(const std::vector<ProcessedLine>& lines);
+
+    // Objective :- Append a copy of one line to the arena
+    // Input :- line - view of the line to copy
+    // Output :- None (void function)
+    // Sideeffect :- Grows the arenas and columns; invalidates views previously returned by line()
+    // Assumption :- line does not point into this arena
+    void append(const LineView& line);
+
+    // Objective :- Reserve room for lines, text bytes and tokens so appends do not reallocate
+    // Input :- lines - number of lines, textBytes - original plus cleaned bytes, tokenCount - number of token IDs
+    // Output :- None (void function)
+    // Sideeffect :- Reserves capacity in arenas and columns
+    // Assumption :- None
+    void reserve(std::size_t lines, std::size_t textBytes, std::size_t tokenCount);
+
+    // Objective :- Replace every stored token ID with its entry in a mapping table (e.g. from a task-local vocabulary to the shared one)
+    // Input :- remap - new ID of each old ID
+    // Output :- None (void function)
+    // Sideeffect :- Rewrites the token column in place
+    // Assumption :- Every stored ID is below remap.size()
+    void remapTokens(const std::vector<TokenId>& remap);
+
+    // Objective :- Report the number of lines stored
+    // Input :- None
+    // Output :- Returns number of lines
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t size() const;
+
+    // Objective :- View one stored line
+    // Input :- i - line index
+    // Output :- Returns LineView pointing into the arenas
+    // Sideeffect :- None
+    // Assumption :- i < size(); the view is valid until the arena is modified or destroyed
+    LineView line(std::size_t i) const;
+
+    // Objective :- Access the token column, every line's token IDs back to back (for kernels that walk many lines at once)
+    // Input :- None
+    // Output :- Returns pointer to the first token ID (line i's tokens start at tokenOffsets()[i])
+    // Sideeffect :- None
+    // Assumption :- The pointer is valid until the arena is modified or destroyed
+    const TokenId* tokenData() const;
+
+    // Objective :- Access the token offset column
+    // Input :- None
+    // Output :- Returns pointer to size() + 1 offsets into tokenData(); line i's tokens are [offsets[i], offsets[i + 1]) (nullptr if the arena is empty)
+    // Sideeffect :- None
+    // Assumption :- The pointer is valid until the arena is modified or destroyed
+    const std::uint32_t* tokenOffsets() const;
+
+private:
+    std::string text;                          // Original then cleaned text of every line, back to back
+    std::vector<TokenId> tokens;               // Token IDs of every line, back to back
+    std::vector<std::size_t> textOffset;       // Column: start of each line's original text in 'text'
+    std::vector<std::uint32_t> originalLength; // Column: length of each line's original text
+    std::vector<std::uint32_t> cleanedLength;  // Column: length of each line's cleaned text (follows the original)
+    std::vector<std::uint32_t> tokenOffset;    // Column: start of each line's tokens in 'tokens' (one extra entry marks the end)
+};
+
+// Objective :- Class presenting the arenas of several documents as one ordered sequence of lines; documents are shared, so rebuilding a corpus after a change copies no text
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class Corpus {
+public:
+    // Objective :- Append a document's lines to the end of the corpus
+    // Input :- doc - shared arena of the document
+    // Output :- None (void function)
+    // Sideeffect :- Stores the pointer and updates the line index
+    // Assumption :- doc is not null and is not modified while it belongs to the corpus
+    void add(std::shared_ptr<const DocumentArena> doc);
+
+    // Objective :- Remove all documents
+    // Input :- None
+    // Output :- None (void function)
+    // Sideeffect :- Releases the corpus's references to the arenas
+    // Assumption :- None
+    void clear();
+
+    // Objective :- Report the total number of lines
+    // Input :- None
+    // Output :- Returns number of lines across all documents
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t size() const;
+
+    // Objective :- Report whether the corpus has no lines
+    // Input :- None
+    // Output :- Returns true if size() is zero
+    // Sideeffect :- None
+    // Assumption :- None
+    bool empty() const;
+
+    // Objective :- View the line at a corpus-wide index
+    // Input :- i - line index in document order
+    // Output :- Returns LineView of the line
+    // Sideeffect :- None
+    // Assumption :- i < size()
+    LineView line(std::size_t i) const;
+
+    // Objective :- Access the documents in order, for sequential walks that stay inside one arena at a time
+    // Input :- None
+    // Output :- Returns reference to the document arenas
+    // Sideeffect :- None
+    // Assumption :- None
+    const std::vector<std::shared_ptr<const DocumentArena>>& documents() const;
+
+private:
+    std::vector<std::shared_ptr<const DocumentArena>> docs;   // Document arenas in order
+    std::vector<std::size_t> firstLine;                       // Corpus-wide index of each document's first line
+    std::size_t total = 0;                                    // Total number of lines
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef CORPUS_MANIFEST_H
+#define CORPUS_MANIFEST_H
+
+#include "corpus.h"
+#include "document.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Objective :- Represents the filesystem metadata used to detect whether a file may have changed
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct FileStamp {
+    long long size{};    // File size in bytes
+    long long mtime{};   // Modification time (nanoseconds where the platform provides them)
+};
+
+// Objective :- Class remembering, per corpus file, its stamp, content hash, processed lines and token counts so unchanged files are never reprocessed
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class CorpusManifest {
+public:
+    // Objective :- Bind the manifest to a corpus root, discarding all cached state if the root changed
+    // Input :- path - cleaned folder or file path being loaded
+    // Output :- None (void function)
+    // Sideeffect :- Clears entries, totals and merged lines and advances generation() when path differs from the current root
+    // Assumption :- None
+    void setRoot(const std::string& path);
+
+    // Objective :- Report how many times the manifest switched to a different root, so the caller can tell when state tied to the previous corpus (e.g. its token IDs) can be dropped
+    // Input :- None
+    // Output :- Returns the number of root changes so far
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t generation() const;
+
+    // Objective :- Check whether a file is tracked with exactly the given stamp (and so needs no reading)
+    // Input :- name - document name, stamp - current size and modification time of the file
+    // Output :- Returns true if the cached entry is up to date
+    // Sideeffect :- None
+    // Assumption :- None
+    bool isCurrent(const std::string& name, const FileStamp& stamp) const;
+
+    // Objective :- Check whether a tracked file already has the given content hash
+    // Input :- name - document name, hash - content hash of the freshly read file
+    // Output :- Returns true if the cached entry was built from identical content
+    // Sideeffect :- None
+    // Assumption :- None
+    bool hasContent(const std::string& name, std::uint64_t hash) const;
+
+    // Objective :- Record a new stamp for a file whose content turned out to be unchanged
+    // Input :- name - document name, stamp - new size and modification time
+    // Output :- None (void function)
+    // Sideeffect :- Updates the stamp of the entry
+    // Assumption :- name is tracked
+    void touch(const std::string& name, const FileStamp& stamp);
+
+    // Objective :- Record the stamp and hash of a new or changed file whose results will be supplied through update()
+    // Input :- name - document name, stamp - size and modification time, hash - content hash
+    // Output :- None (void function)
+    // Sideeffect :- Creates the entry if needed and stores stamp and hash
+    // Assumption :- update() is called for name before lines() or frequency() are used
+    void track(const std::string& name, const FileStamp& stamp, std::uint64_t hash);
+
+    // Objective :- Replace the cached results of a document and merge the count delta into the global frequency map
+    // Input :- name - document name, lines - processed lines of the document (its arenas, e.g. from Preprocessor::processEach), counts - sparse token counts of the document
+    // Output :- None (void function)
+    // Sideeffect :- Subtracts old counts, adds new counts and document frequencies, keeps the lines' arenas and the counts, marks merged lines for rebuild
+    // Assumption :- name was passed to track() first
+    void update(const std::string& name, Corpus lines,
+                TokenCounts counts);
+
+    // Objective :- Forget a document and remove its counts from the global frequency map
+    // Input :- name - document name
+    // Output :- None (void function)
+    // Sideeffect :- Erases the entry and marks merged lines for rebuild
+    // Assumption :- None (unknown names are ignored)
+    void remove(const std::string& name);
+
+    // Objective :- Forget every document whose name is not in the given list
+    // Input :- names - sorted names of the files currently present
+    // Output :- None (void function)
+    // Sideeffect :- Removes entries of deleted files and their counts
+    // Assumption :- names is sorted ascending
+    void retain(const std::vector<std::string>& names);
+
+    // Objective :- Report whether any document is tracked
+    // Input :- None
+    // Output :- Returns true if the manifest has no entries
+    // Sideeffect :- None
+    // Assumption :- None
+    bool empty() const;
+
+    // Objective :- Processed lines of all documents in name order, rebuilt only after a change
+    // Input :- None
+    // Output :- Returns reference to the corpus of all document arenas
+    // Sideeffect :- Rebuilds the corpus index if any document changed since the last call (arenas are shared, no text is copied)
+    // Assumption :- Reference is invalidated by the next change; arenas stay alive while the corpus refers to them
+    const Corpus& lines();
+
+    // Objective :- Global token frequencies (indexed by token ID) kept up to date by merging per-document deltas
+    // Input :- None
+    // Output :- Returns reference to the frequency vector
+    // Sideeffect :- None
+    // Assumption :- Token IDs come from one Vocabulary for the lifetime of the manifest
+    const std::vector<std::uint32_t>& frequency() const;
+
+    // Objective :- Document frequencies (indexed by token ID): the number of documents each token occurs in, kept up to date with the same per-document deltas as frequency()
+    // Input :- None
+    // Output :- Returns reference to the document frequency vector
+    // Sideeffect :- None
+    // Assumption :- Token IDs come from one Vocabulary for the lifetime of the manifest
+    const std::vector<std::uint32_t>& documentFrequency() const;
+
+    // Objective :- Report the number of documents the frequencies cover
+    // Input :- None
+    // Output :- Returns number of tracked documents
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t documentCount() const;
+
+    // Objective :- Compute a 64-bit FNV-1a hash of file contents
+    // Input :- text - view over the file contents
+    // Output :- Returns the hash value
+    // Sideeffect :- None
+    // Assumption :- None
+    static std::uint64_t hashContent(std::string_view text);
+
+private:
+    // Objective :- Cached state of one corpus file
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct Entry {
+        FileStamp stamp;                                        // Stamp seen when the file was last read
+        std::uint64_t hash{};                                   // Content hash of the file
+        Corpus lines;                                           // Cached processed lines (the document's arenas)
+        TokenCounts counts;                                     // Cached non-zero token counts
+    };
+
+    std::string root;                                           // Folder or file the manifest describes
+    std::map<std::string, Entry> entries;                       // Entries keyed (and ordered) by document name
+    std::vector<std::uint32_t> totals;                          // Global token frequencies indexed by token ID
+    std::vector<std::uint32_t> docFreq;                         // Number of documents containing each token ID
+    Corpus merged;                                              // Combined processed lines of all entries
+    bool dirty = true;                                          // True when merged must be rebuilt
+    std::size_t rootChanges = 0;                                // Number of times root changed
+
+    // Objective :- Remove an entry's token counts from the global frequency map
+    // Input :- entry - entry whose counts are subtracted
+    // Output :- None (void function)
+    // Sideeffect :- Decrements totals and document frequencies
+    // Assumption :- entry counts were previously added to totals
+    void subtract(const Entry& entry);
+};
+
+#endif
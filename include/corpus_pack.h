@@ -0,0 +1,56 @@
+#ifndef CORPUS_PACK_H
+#define CORPUS_PACK_H
+
+#include "document.h"
+#include "file_buffer.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Objective :- Class reading and writing packed corpus files (.qpack): a single file holding many documents with a precomputed line index, so a whole syllabus loads with one open and one mapping
+//
+// Layout (all integers little-endian, sections 8-byte aligned):
+//   header     : magic "QPGPACK1", u32 version, u32 document count,
+//                u64 offsets of the document table, name, text and line sections, u64 total file size
+//   documents  : per document u64 name offset, u32 name length, u32 line count,
+//                u64 text offset, u64 text length, u64 index of its first line entry
+//   names      : concatenated document names
+//   text       : concatenated raw file contents
+//   lines      : per line u32 start (relative to its document text), u32 length (line terminator excluded)
+//
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class CorpusPack {
+public:
+    // Objective :- Write documents to a packed corpus file
+    // Input :- docs - documents to pack (their text holds the raw file contents), path - output file path
+    // Output :- Returns true on success, false if the file cannot be written or a document exceeds the format limits
+    // Sideeffect :- Creates or overwrites the output file, writes error message to cerr on failure
+    // Assumption :- Each document's line views point into its text
+    static bool write(const std::vector<Document>& docs, const std::string& path);
+
+    // Objective :- Decode a packed corpus into Documents whose lines are views into the pack buffer
+    // Input :- buffer - contents of a .qpack file (normally memory-mapped), path - file path used in error messages
+    // Output :- Returns the packed documents (empty if the pack is malformed)
+    // Sideeffect :- Writes error message to cerr if validation fails
+    // Assumption :- None (every offset is checked against the buffer size)
+    static std::vector<Document> read(const std::shared_ptr<const FileBuffer>& buffer, const std::string& path);
+
+    // Objective :- Walk the document table of a packed corpus, decoding one document's line index at a time and handing it to a callback, so memory does not grow with the pack
+    // Input :- buffer - contents of a .qpack file, path - file path used in error messages, visit - callback receiving each document with lines (returns false to stop early)
+    // Output :- Returns false if the pack is malformed (documents before the malformed entry have already been visited), true otherwise
+    // Sideeffect :- Calls visit once per document with lines, in pack order; writes error message to cerr if validation fails
+    // Assumption :- None (every offset is checked against the buffer size)
+    static bool forEachDocument(const std::shared_ptr<const FileBuffer>& buffer, const std::string& path, const std::function<bool(Document&&)>& visit);
+
+    // Objective :- Determine if a filename has the .qpack extension (case-insensitive)
+    // Input :- filename - string containing filename to check
+    // Output :- Returns true if filename ends with .qpack
+    // Sideeffect :- None
+    // Assumption :- None
+    static bool isPackFile(const std::string& filename);
+};
+
+#endif
@@ -1,26 +1,69 @@
 #ifndef DOCUMENT_H
 #define DOCUMENT_H
 
+#include "file_buffer.h"
+#include "vocabulary.h"
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-// Objective :- Represents a document loaded from a text file with its name and content lines
+// Objective :- Represents a document loaded from a text file with its name and content lines. Lines are views into the shared file buffer, so the document owns no per-line heap strings.
 // Input :- None (data structure)
 // Output :- None (data structure)
 // Sideeffect :- None
 struct Document {
-    std::string name;                    // Name of the document file
-    std::vector<std::string> lines;      // Vector containing all lines of text from the document
+    std::string name;                              // Name of the document file
+    std::shared_ptr<const FileBuffer> buffer;      // Buffer that the text and line views point into (may be shared by several documents)
+    std::string_view text;                         // Whole contents of the document
+    std::vector<std::string_view> lines;           // Views of all lines of text from the document (without line terminators)
 };
 
-// Objective :- Represents a processed line of text with original text, cleaned text, and tokenized words
+// Objective :- Represents a batch of consecutive lines from one file, the unit of work of the streaming pipeline
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct LineBatch {
+    std::size_t sequence{};                        // Position of the batch in load order
+    std::shared_ptr<const FileBuffer> buffer;      // File contents that the line views point into
+    std::vector<std::string_view> lines;           // Views of the lines in this batch
+    std::size_t bytes{};                           // Total number of text bytes in the batch
+};
+
+// Objective :- Represents a processed line of text with original text, cleaned text, and the interned IDs of its words
 // Input :- None (data structure)
 // Output :- None (data structure)
 // Sideeffect :- None
 struct ProcessedLine {
     std::string original;                // Original unprocessed line text
     std::string cleaned;                 // Normalized and cleaned line text
-    std::vector<std::string> tokens;    // Vector of tokens (words) extracted from cleaned text
+    std::vector<TokenId> tokens;         // IDs of the tokens (words) extracted from cleaned text, see Vocabulary
+};
+
+// Objective :- Read-only view of a contiguous run of token IDs (e.g. one line's tokens inside a DocumentArena)
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct TokenSpan {
+    const TokenId* ids{};                // First token ID
+    std::size_t count{};                 // Number of token IDs
+
+    const TokenId* begin() const { return ids; }            // Start of iteration
+    const TokenId* end() const { return ids + count; }      // End of iteration
+    std::size_t size() const { return count; }              // Number of tokens
+    bool empty() const { return count == 0; }               // True if the line has no tokens
+    TokenId operator[](std::size_t i) const { return ids[i]; } // Token ID at position i
+};
+
+// Objective :- Read-only, ProcessedLine-compatible view of a processed line whose text and tokens live elsewhere (a DocumentArena or a ProcessedLine)
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct LineView {
+    std::string_view original;           // Original unprocessed line text
+    std::string_view cleaned;            // Normalized and cleaned line text
+    TokenSpan tokens;                    // IDs of the tokens extracted from cleaned text
 };
 
 // Objective :- Represents a processed line with an associated importance score
@@ -28,10 +71,19 @@ struct ProcessedLine {
 // Output :- None (data structure)
 // Sideeffect :- None
 struct ScoredLine {
-    ProcessedLine line;                  // Processed line data
+    LineView line;                       // View of the processed line (valid while the storage it points into is alive)
     double score{};                      // Importance score (higher = more important)
 };
 
+// Objective :- Compact reference to a scored line: its corpus-wide index and its score (8 bytes, where a ScoredLine carries a full view)
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct ScoredRef {
+    std::uint32_t index{};               // Corpus-wide index of the line (see Corpus::line)
+    float score{};                       // Importance score (higher = more important)
+};
+
 // Objective :- Represents a multiple choice question with prompt, options, and correct answer
 // Input :- None (data structure)
 // Output :- None (data structure)
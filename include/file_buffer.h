@@ -0,0 +1,69 @@
+#ifndef FILE_BUFFER_H
+#define FILE_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Objective :- Read-only buffer holding the complete contents of one file, either memory-mapped or read into heap memory
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class FileBuffer {
+public:
+    // Objective :- Map a file read-only into memory so its bytes are served straight from the page cache
+    // Input :- path - string containing path to the file to map
+    // Output :- Returns shared pointer to the mapped buffer, or nullptr if the file cannot be opened or mapped
+    // Sideeffect :- Opens the file, creates a memory mapping, closes the file descriptor, writes error message to cerr on failure
+    // Assumption :- path points to a regular file, filesystem permissions allow reading
+    static std::shared_ptr<const FileBuffer> map(const std::string& path);
+
+    // Objective :- Read a whole file into a single heap buffer through an input stream
+    // Input :- path - string containing path to the file to read
+    // Output :- Returns shared pointer to the loaded buffer, or nullptr if the file cannot be opened
+    // Sideeffect :- Opens file stream, reads file content, writes error message to cerr on failure
+    // Assumption :- path points to a readable file
+    static std::shared_ptr<const FileBuffer> read(const std::string& path);
+
+    // Objective :- Wrap an in-memory string as a buffer (takes ownership of the string)
+    // Input :- text - string whose contents become the buffer
+    // Output :- Returns shared pointer to the buffer
+    // Sideeffect :- Moves text into the buffer
+    // Assumption :- None
+    static std::shared_ptr<const FileBuffer> fromString(std::string text);
+
+    // Objective :- Release the memory mapping (if any) held by this buffer
+    // Input :- None
+    // Output :- None (destructor)
+    // Sideeffect :- Unmaps the file region
+    // Assumption :- None
+    ~FileBuffer();
+
+    FileBuffer(const FileBuffer&) = delete;
+    FileBuffer& operator=(const FileBuffer&) = delete;
+
+    // Objective :- Access the buffer contents as a string view
+    // Input :- None
+    // Output :- Returns view over all bytes of the file
+    // Sideeffect :- None
+    // Assumption :- Buffer outlives the returned view
+    std::string_view view() const { return std::string_view(start, length); }
+
+    // Objective :- Report whether the buffer is backed by a memory mapping rather than heap memory
+    // Input :- None
+    // Output :- Returns true for mapped buffers
+    // Sideeffect :- None
+    // Assumption :- None
+    bool isMapped() const { return mapping != nullptr; }
+
+private:
+    FileBuffer() = default;
+
+    const char* start = nullptr;   // First byte of the file contents
+    std::size_t length = 0;        // Number of bytes in the file
+    void* mapping = nullptr;       // Base address of the memory mapping (nullptr for heap buffers)
+    std::string owned;             // Heap storage used when the file is not mapped
+};
+
+#endif
@@ -1,8 +1,13 @@
 #ifndef FILE_MANAGER_H
 #define FILE_MANAGER_H
 
+#include "corpus_manifest.h"
 #include "document.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Objective :- Class for managing file operations: loading documents from folders or individual files
@@ -11,22 +16,108 @@
 // Sideeffect :- None
 class FileManager {
 public:
+    // Objective :- Selects how file contents are brought into memory
+    // Input :- None (enum declaration)
+    // Output :- None (enum declaration)
+    // Sideeffect :- None
+    enum class LoadMode {
+        Mapped,     // Memory-map each file; lines are views straight into the page cache
+        Buffered    // Read each file into one heap buffer through an input stream
+    };
+
     // Objective :- Initialize FileManager with a folder or file path for document loading
-    // Input :- folderPath - string containing path to folder or .txt file
+    // Input :- folderPath - string containing path to folder or .txt file, mode - how file contents are loaded (default memory-mapped)
     // Output :- None (constructor)
-    // Sideeffect :- Stores the provided path in member variable folderPath
+    // Sideeffect :- Stores the provided path and mode in member variables
     // Assumption :- folderPath is a valid string (may be empty or invalid path)
-    explicit FileManager(std::string folderPath);
+    explicit FileManager(std::string folderPath, LoadMode mode = LoadMode::Mapped);
     
-    // Objective :- Load all .txt documents from a folder path or load a single .txt file. Handles both file and directory paths.
-    // Input :- None (uses member variable folderPath)
-    // Output :- Returns vector of Document objects containing loaded text files
-    // Sideeffect :- Reads files from filesystem, writes error messages to cerr, may open and close file streams
+    // Objective :- Summary of one loadDocuments call, used to report load throughput
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct LoadStats {
+        std::size_t files{};       // Number of documents loaded
+        std::size_t bytes{};       // Total size of the files read in bytes
+        std::size_t unchanged{};   // Files reused from the manifest without reprocessing (refresh only)
+        double seconds{};          // Wall-clock time spent loading
+    };
+
+    // Objective :- Load all .txt documents from a folder path, a single .txt file, or every document of a packed corpus (.qpack). Handles both file and directory paths.
+    // Input :- stats - optional pointer receiving file count, byte count and elapsed time of the load
+    // Output :- Returns vector of Document objects containing loaded text files (directory entries in name order)
+    // Sideeffect :- Reads files from filesystem on worker threads, writes error messages to cerr, may fill *stats
     // Assumption :- folderPath member variable contains a valid path string, filesystem permissions allow reading
-    std::vector<Document> loadDocuments() const;
+    std::vector<Document> loadDocuments(LoadStats* stats = nullptr) const;
+
+    // Objective :- Bring a manifest up to date with the folder or file and load only documents that are new or changed
+    // Input :- manifest - manifest from the previous run (reset automatically if the path changed), stats - optional pointer receiving load statistics
+    // Output :- Returns the new or changed Documents in name order; unchanged files are not read at all
+    // Sideeffect :- Calls stat on every file, reads files whose size or mtime changed, updates stamps, tracks changed files, drops deleted or emptied files from the manifest
+    // Assumption :- Caller passes every returned document to manifest.update() before using the manifest's lines or frequencies
+    std::vector<Document> refresh(CorpusManifest& manifest, LoadStats* stats = nullptr) const;
+
+    // Objective :- Stream the lines of every input file as batches of bounded size, one file buffer open at a time
+    // Input :- batchBytes - target number of text bytes per batch, sink - callback receiving each batch (returns false to stop early)
+    // Output :- Returns false if the path is invalid, true otherwise
+    // Sideeffect :- Maps or reads files one after another (decoding a packed corpus one document at a time), calls sink for every batch, writes error messages to cerr
+    // Assumption :- sink may block (e.g. on a full queue); batches keep their file buffer alive on their own
+    bool streamBatches(std::size_t batchBytes, const std::function<bool(LineBatch&&)>& sink) const;
+
+    // Objective :- Set the number of worker threads used to read directory entries
+    // Input :- count - number of threads (0 means one per hardware thread)
+    // Output :- None (void function)
+    // Sideeffect :- Updates member variable threads
+    // Assumption :- None
+    void setThreads(std::size_t count);
 
 private:
-    std::string folderPath;  // Path to folder or file for document loading
+    std::string folderPath;    // Path to folder or file for document loading
+    LoadMode mode;             // How file contents are brought into memory
+    std::size_t threads = 0;   // Worker threads for directory loading (0 = all cores)
+
+    // Objective :- Clean the configured path by trimming whitespace and removing surrounding quotes
+    // Input :- None (uses member variable folderPath)
+    // Output :- Returns cleaned path string (may be empty)
+    // Sideeffect :- None
+    // Assumption :- None
+    std::string cleanPath() const;
+
+    // Objective :- List the .txt regular files of a directory in a single readdir pass, sorted by name
+    // Input :- dirPath - string containing path to an existing directory
+    // Output :- Returns sorted vector of matching file names (not full paths)
+    // Sideeffect :- Opens and closes directory stream, calls stat only for entries whose type readdir cannot report
+    // Assumption :- dirPath names a readable directory
+    static std::vector<std::string> listTextFiles(const std::string& dirPath);
+
+    // Objective :- Resolve the configured path into the list of .txt files it denotes
+    // Input :- path - receives the cleaned path, names - receives document names, paths - receives full file paths (parallel to names), packed - set to true if path is a packed corpus file
+    // Output :- Returns true if the path exists and is a directory, a .txt file or a .qpack file, false otherwise
+    // Sideeffect :- Calls stat on the path, enumerates directories, writes error messages to cerr
+    // Assumption :- None
+    bool collectInputs(std::string& path, std::vector<std::string>& names, std::vector<std::string>& paths,
+                       bool& packed) const;
+
+    // Objective :- Load files on the worker pool and keep the non-empty ones in input order
+    // Input :- paths - full paths of the files, names - document names (parallel to paths)
+    // Output :- Returns vector of non-empty Documents ordered like paths
+    // Sideeffect :- Maps or reads files on worker threads, writes error messages to cerr for unreadable files
+    // Assumption :- paths and names have equal length
+    std::vector<Document> loadAll(const std::vector<std::string>& paths, const std::vector<std::string>& names) const;
+
+    // Objective :- Read the size and modification time of a file
+    // Input :- path - string containing path to the file
+    // Output :- Returns FileStamp of the file (all zero if stat fails)
+    // Sideeffect :- Calls stat system call
+    // Assumption :- None
+    static FileStamp stampOf(const std::string& path);
+
+    // Objective :- Join a directory path and an entry name with a separator when needed
+    // Input :- dirPath - directory path, name - entry name
+    // Output :- Returns combined path string
+    // Sideeffect :- None
+    // Assumption :- dirPath is non-empty
+    static std::string joinPath(const std::string& dirPath, const std::string& name);
     
     // Objective :- Check if the given path points to a regular file (not a directory or special file)
     // Input :- path - string containing file system path to check
@@ -42,12 +133,26 @@ private:
     // Assumption :- filename is a valid string, may or may not contain extension
     static bool isTextFile(const std::string& filename);
     
-    // Objective :- Read all lines from a text file and return them as a vector of strings
-    // Input :- filepath - string containing path to the file to read
-    // Output :- Returns vector of strings, each string representing one line from the file
-    // Sideeffect :- Opens file stream, reads file content, writes error message to cerr if file cannot be opened
+    // Objective :- Bring a file's contents into memory according to the loading mode
+    // Input :- filepath - string containing path to the file
+    // Output :- Returns shared pointer to the file buffer, or nullptr if the file cannot be read
+    // Sideeffect :- Maps or reads the file (falls back to reading if mapping fails), writes error message to cerr on failure
+    // Assumption :- filepath points to a regular file
+    std::shared_ptr<const FileBuffer> openBuffer(const std::string& filepath) const;
+
+    // Objective :- Load a text file into a Document whose lines are views over the file buffer
+    // Input :- filepath - string containing path to the file to read, name - document name to store
+    // Output :- Returns Document with buffer and line views (no lines if the file cannot be read)
+    // Sideeffect :- Maps or reads the file depending on mode, writes error message to cerr if file cannot be opened
     // Assumption :- filepath points to a valid readable file, file permissions allow reading
-    static std::vector<std::string> readFileLines(const std::string& filepath);
+    Document loadFile(const std::string& filepath, const std::string& name) const;
+
+    // Objective :- Build the line index of a text buffer in one pass, splitting on newlines like std::getline
+    // Input :- text - view over the whole file contents
+    // Output :- Returns views of each line without the trailing newline (and without a trailing carriage return)
+    // Sideeffect :- None
+    // Assumption :- text stays alive while the returned views are used
+    static std::vector<std::string_view> indexLines(std::string_view text);
 };
 
 #endif 
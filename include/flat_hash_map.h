@@ -0,0 +1,222 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Objective :- Hash functor for token text that accepts any string type through std::string_view, so maps keyed by strings or views can be probed with a view without building a string
+// Input :- text - token text
+// Output :- Returns hash value
+// Sideeffect :- None
+// Assumption :- None
+struct TextHash {
+    std::size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+};
+
+// Objective :- Class mapping keys to values in one flat array with open addressing (linear probing) and a stored hash per slot, so a lookup touches one or two adjacent cache lines instead of chasing a node pointer per entry as std::unordered_map does
+// Input :- None (class template declaration); Key, Value - default-constructible types, Hash - functor hashing Key and every type find() is called with
+// Output :- None (class template declaration)
+// Sideeffect :- None
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap {
+public:
+    // Objective :- Create an empty map
+    // Input :- hash - hash functor
+    // Output :- None (constructor)
+    // Sideeffect :- None (the slot array is allocated on first insertion)
+    // Assumption :- None
+    explicit FlatHashMap(Hash hash = Hash()) : hasher(std::move(hash)) {}
+
+    // Objective :- Look up a key, possibly through a different but comparable type (e.g. a std::string_view for std::string keys)
+    // Input :- key - key to look for
+    // Output :- Returns pointer to the value, or nullptr if the key is absent
+    // Sideeffect :- None
+    // Assumption :- Hash gives equal hashes for equal keys of either type; the pointer is valid until the next insertion or erase
+    template <typename K>
+    Value* find(const K& key) {
+        if (count == 0)
+            return nullptr;
+        std::size_t i = locate(key, mix(hasher(key)));
+        return slots[i].hash ? &slots[i].value : nullptr;
+    }
+
+    // Objective :- Look up a key, possibly through a different but comparable type (e.g. a std::string_view for std::string keys)
+    // Input :- key - key to look for
+    // Output :- Returns pointer to the value, or nullptr if the key is absent
+    // Sideeffect :- None
+    // Assumption :- Hash gives equal hashes for equal keys of either type; the pointer is valid until the next insertion or erase
+    template <typename K>
+    const Value* find(const K& key) const {
+        if (count == 0)
+            return nullptr;
+        std::size_t i = locate(key, mix(hasher(key)));
+        return slots[i].hash ? &slots[i].value : nullptr;
+    }
+
+    // Objective :- Insert a key with a value unless the key is already present
+    // Input :- key - key to insert, value - value stored if the key is new
+    // Output :- Returns pair (pointer to the key's value, true if it was inserted)
+    // Sideeffect :- May grow and rehash the slot array
+    // Assumption :- The pointer is valid until the next insertion or erase
+    std::pair<Value*, bool> insert(const Key& key, Value value) {
+        // Keep the load at most 3/4 so probe runs stay short
+        if ((count + 1) * 4 > slots.size() * 3)
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        std::uint64_t h = mix(hasher(key));
+        std::size_t i = locate(key, h);
+        if (slots[i].hash)
+            return {&slots[i].value, false};
+        slots[i].hash = h;
+        slots[i].key = key;
+        slots[i].value = std::move(value);
+        count++;
+        return {&slots[i].value, true};
+    }
+
+    // Objective :- Access the value of a key, inserting a default value if the key is new
+    // Input :- key - key to access
+    // Output :- Returns reference to the value
+    // Sideeffect :- May insert and rehash
+    // Assumption :- The reference is valid until the next insertion or erase
+    Value& operator[](const Key& key) {
+        return *insert(key, Value()).first;
+    }
+
+    // Objective :- Remove a key
+    // Input :- key - key to remove
+    // Output :- Returns true if the key was present
+    // Sideeffect :- Shifts later entries of the probe run back so no tombstones are needed
+    // Assumption :- None
+    template <typename K>
+    bool erase(const K& key) {
+        if (count == 0)
+            return false;
+        std::size_t i = locate(key, mix(hasher(key)));
+        if (!slots[i].hash)
+            return false;
+        // Backward shift: move each following entry into the hole unless it already sits at or after its home slot relative to the hole
+        std::size_t hole = i;
+        for (std::size_t j = (i + 1) & mask;; j = (j + 1) & mask) {
+            if (!slots[j].hash)
+                break;
+            std::size_t home = homeOf(slots[j].hash);
+            // Entry may move if its home is not cyclically within (hole, j]
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                slots[hole] = std::move(slots[j]);
+                hole = j;
+            }
+        }
+        slots[hole] = Slot();
+        count--;
+        return true;
+    }
+
+    // Objective :- Make room for a number of entries so inserting them does not rehash
+    // Input :- n - expected number of entries
+    // Output :- None (void function)
+    // Sideeffect :- May grow and rehash the slot array
+    // Assumption :- None
+    void reserve(std::size_t n) {
+        std::size_t capacity = 16;
+        while (n * 4 > capacity * 3)
+            capacity *= 2;
+        if (capacity > slots.size())
+            rehash(capacity);
+    }
+
+    // Objective :- Remove all entries
+    // Input :- None
+    // Output :- None (void function)
+    // Sideeffect :- Releases the slot array
+    // Assumption :- None
+    void clear() {
+        slots.clear();
+        mask = 0;
+        count = 0;
+    }
+
+    // Objective :- Report the number of entries
+    // Input :- None
+    // Output :- Returns number of keys stored
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t size() const {
+        return count;
+    }
+
+private:
+    // Objective :- Represents one slot of the table
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct Slot {
+        std::uint64_t hash{};   // Mixed hash of the key (0 = empty slot)
+        Key key{};              // Key
+        Value value{};          // Value
+    };
+
+    Hash hasher;                 // Key hash functor
+    std::vector<Slot> slots;     // Slot array (size is zero or a power of two)
+    std::size_t mask = 0;        // slots.size() - 1
+    std::size_t count = 0;       // Number of occupied slots
+
+    // Objective :- Spread a hash over all 64 bits (Fibonacci hashing) so identity hashes of small integers still fill the table evenly
+    // Input :- h - hash from the functor
+    // Output :- Returns non-zero mixed hash
+    // Sideeffect :- None
+    // Assumption :- None
+    static std::uint64_t mix(std::size_t h) {
+        std::uint64_t x = static_cast<std::uint64_t>(h) * 0x9E3779B97F4A7C15ULL;
+        x ^= x >> 32;
+        return x ? x : 1;
+    }
+
+    // Objective :- Compute the slot a hash starts probing at
+    // Input :- h - mixed hash
+    // Output :- Returns slot index
+    // Sideeffect :- None
+    // Assumption :- slots is not empty
+    std::size_t homeOf(std::uint64_t h) const {
+        return static_cast<std::size_t>(h) & mask;
+    }
+
+    // Objective :- Find the slot holding a key, or the empty slot that ends its probe run
+    // Input :- key - key to look for, h - its mixed hash
+    // Output :- Returns slot index
+    // Sideeffect :- None
+    // Assumption :- slots is not empty and always has an empty slot (load below 1)
+    template <typename K>
+    std::size_t locate(const K& key, std::uint64_t h) const {
+        // Compare stored hashes first; keys are only compared on a full hash match
+        for (std::size_t i = homeOf(h);; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (!slot.hash || (slot.hash == h && slot.key == key))
+                return i;
+        }
+    }
+
+    // Objective :- Move all entries into a slot array of a new size
+    // Input :- capacity - new number of slots (power of two, above the entry count)
+    // Output :- None (void function)
+    // Sideeffect :- Replaces the slot array; invalidates value pointers
+    // Assumption :- None
+    void rehash(std::size_t capacity) {
+        std::vector<Slot> old(capacity);
+        old.swap(slots);
+        mask = capacity - 1;
+        for (auto& slot : old) {
+            if (!slot.hash)
+                continue;
+            std::size_t i = homeOf(slot.hash);
+            while (slots[i].hash)
+                i = (i + 1) & mask;
+            slots[i] = std::move(slot);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef KEYPHRASE_EXTRACTOR_H
+#define KEYPHRASE_EXTRACTOR_H
+
+#include "corpus.h"
+#include "vocabulary.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Objective :- Class extracting repeated multi-word keyphrases ("binary search tree") from the corpus token stream with a suffix array and an LCP array
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class KeyphraseExtractor {
+public:
+    // Objective :- Initialize the extractor with the phrase length limit and the minimum number of occurrences
+    // Input :- maxLength - longest phrase in words (2 to 255), minCount - fewest occurrences a phrase needs (at least 2)
+    // Output :- None (constructor)
+    // Sideeffect :- Stores settings
+    // Assumption :- None (out-of-range values are clamped)
+    explicit KeyphraseExtractor(std::size_t maxLength = 4, std::size_t minCount = 2);
+
+    // Objective :- Find the most frequent repeated phrases of 2..maxLength words, never crossing a line boundary
+    // Input :- corpus - processed lines whose tokens form the token stream, vocab - vocabulary used to render phrases, limit - maximum number of phrases to return
+    // Output :- Returns vector of pairs (phrase with words separated by single spaces, occurrence count) sorted by count descending, then word by word for ties
+    // Sideeffect :- Builds the token stream, suffix array and LCP array (about 13 bytes per token, released on return)
+    // Assumption :- All token IDs in corpus are in vocab. Only maximal phrases are reported: a phrase is dropped when every occurrence extends by the same word on the right or on the left.
+    std::vector<std::pair<std::string, std::size_t>> topPhrases(const Corpus& corpus, const Vocabulary& vocab,
+                                                                std::size_t limit) const;
+
+    // Objective :- Build a suffix array of a symbol sequence, sorting suffixes by at most their first 'depth' symbols: one radix pass per symbol for shallow depths, prefix doubling with radix sort otherwise
+    // Input :- text - symbol sequence, alphabet - one past the largest symbol, depth - number of leading symbols that must be fully ordered (0 = whole suffixes)
+    // Output :- Returns the start positions of the suffixes in sorted order (suffixes equal in their first 'depth' symbols appear in an unspecified order)
+    // Sideeffect :- None
+    // Assumption :- Every symbol is below alphabet; text.size() fits in 32 bits
+    static std::vector<std::uint32_t> suffixArray(const std::vector<std::uint32_t>& text, std::size_t alphabet,
+                                                  std::size_t depth = 0);
+
+private:
+    std::size_t maxLength;   // Longest phrase in words
+    std::size_t minCount;    // Fewest occurrences a reported phrase needs
+};
+
+#endif
@@ -1,31 +1,100 @@
 #ifndef KEYWORD_EXTRACTOR_H
 #define KEYWORD_EXTRACTOR_H
 
-#include <string>
-#include <unordered_map>
+#include "corpus.h"
+#include "document.h"
+#include "top_k.h"
+#include "vocabulary.h"
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
-// Objective :- Class for extracting keywords from tokens by calculating frequencies and ranking them
+// Objective :- Class selecting the top keywords from (keyword ID, count) entries fed one at a time, in the order topKeywords uses: count descending, then alphabetically for ties
 // Input :- None (class declaration)
 // Output :- None (class declaration)
 // Sideeffect :- None
-class KeywordExtractor {
+class KeywordTopK {
 public:
-    // Objective :- Count the frequency of each token in the input vector and return a frequency map
-    // Input :- tokens - vector of strings containing tokens to count
-    // Output :- Returns unordered_map with token as key and frequency count as value
+    // Objective :- Create an empty selection of at most 'limit' keywords
+    // Input :- vocab - vocabulary used to order ties by text, limit - maximum number of keywords to keep
+    // Output :- None (constructor)
+    // Sideeffect :- Reserves room for limit entries
+    // Assumption :- vocab outlives the selection and holds every ID that is added
+    KeywordTopK(const Vocabulary& vocab, std::size_t limit);
+
+    // Objective :- Offer one keyword with its final count
+    // Input :- id - keyword ID, count - number of occurrences
+    // Output :- None (void function)
+    // Sideeffect :- May replace the lowest-ranked kept keyword; zero counts are ignored
+    // Assumption :- Each ID is added at most once
+    void add(TokenId id, std::size_t count);
+
+    // Objective :- Move the selected keywords out, best first
+    // Input :- None
+    // Output :- Returns vector of pairs (keyword ID, frequency) sorted by frequency descending, then alphabetically
+    // Sideeffect :- Leaves the selection empty
+    // Assumption :- None
+    std::vector<std::pair<TokenId, std::size_t>> take();
+
+private:
+    // Objective :- Ranking of (keyword ID, count) entries: higher count first, then alphabetical text
+    // Input :- a, b - entries to compare
+    // Output :- Returns true if a ranks before b
     // Sideeffect :- None
-    // Assumption :- tokens vector may be empty, all tokens are valid strings
-    std::unordered_map<std::string, std::size_t> frequency(const std::vector<std::string>& tokens) const;
+    // Assumption :- Both IDs are in vocab
+    struct ByRank {
+        const Vocabulary* vocab;   // Vocabulary used to order ties by text
+        bool operator()(const std::pair<TokenId, std::size_t>& a, const std::pair<TokenId, std::size_t>& b) const;
+    };
+
+    TopK<std::pair<TokenId, std::size_t>, ByRank> top;   // Bounded heap of the best keywords so far
+};
+
+// Objective :- Class for extracting keywords from tokens by calculating frequencies and ranking them. Frequencies are flat vectors indexed by token ID.
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class KeywordExtractor {
+public:
+    // Objective :- Count the tokens of several documents on several threads, straight from the token columns of their arenas
+    // Input :- docs - processed lines of each document (e.g. from Preprocessor::processEach), threads - number of worker threads (0 = all cores)
+    // Output :- Returns one sparse count list per document: (token ID, occurrences) in order of first occurrence
+    // Sideeffect :- Counts the arenas in parallel into per-thread tables, then merges each document's arenas in parallel
+    // Assumption :- docs is not modified during the call
+    std::vector<TokenCounts> countEach(const std::vector<Corpus>& docs, std::size_t threads) const;
     
-    // Objective :- Extract top N keywords from frequency map, sorted by frequency (descending), then alphabetically for ties
-    // Input :- freq - unordered_map containing token frequencies, limit - maximum number of keywords to return
-    // Output :- Returns vector of pairs (keyword, frequency) sorted by frequency descending, limited to 'limit' entries
-    // Sideeffect :- Creates and sorts a vector, may resize the result vector
-    // Assumption :- freq map may be empty, limit is a positive integer
-    std::vector<std::pair<std::string, std::size_t>> topKeywords(
-        const std::unordered_map<std::string, std::size_t>& freq, std::size_t limit) const;
+    // Objective :- Add the token counts of a batch of processed lines to an existing frequency vector
+    // Input :- lines - processed lines whose tokens are counted, counts - frequency vector to update
+    // Output :- None (void function)
+    // Sideeffect :- Grows counts to cover new IDs, increments counts for every token in lines
+    // Assumption :- lines may be empty
+    void accumulate(const std::vector<ProcessedLine>& lines, std::vector<std::uint32_t>& counts) const;
+    
+    // Objective :- Extract top N keywords from a frequency vector, sorted by frequency (descending), then alphabetically for ties
+    // Input :- freq - frequency of each token ID, vocab - vocabulary used to order ties by text, limit - maximum number of keywords to return
+    // Output :- Returns vector of pairs (keyword ID, frequency) sorted by frequency descending, limited to 'limit' entries
+    // Sideeffect :- Keeps a bounded heap of 'limit' entries (O(V log limit) time for V token IDs)
+    // Assumption :- freq may be empty (zero counts are skipped), every ID with a non-zero count is in vocab, limit is a positive integer
+    std::vector<std::pair<TokenId, std::size_t>> topKeywords(
+        const std::vector<std::uint32_t>& freq, const Vocabulary& vocab, std::size_t limit) const;
+
+    // Objective :- Weight every token by TF-IDF: its corpus frequency times log((documents + 1) / document frequency), so words found in every document (boilerplate such as "chapter") weigh little next to words concentrated in a few
+    // Input :- freq - frequency of each token ID, docFreq - number of documents containing each token ID, documents - number of documents
+    // Output :- Returns weight of each token ID (same size as freq; tokens that do not occur weigh zero)
+    // Sideeffect :- Creates weight vector
+    // Assumption :- docFreq covers every ID with a non-zero count in freq; with a single document the weights are proportional to freq
+    std::vector<float> tfidf(const std::vector<std::uint32_t>& freq, const std::vector<std::uint32_t>& docFreq,
+                             std::size_t documents) const;
+
+    // Objective :- Extract top N keywords by weight (e.g. from tfidf()), then alphabetically for ties
+    // Input :- weight - weight of each token ID, freq - frequency of each token ID (reported with the keyword), vocab - vocabulary used to order ties by text, limit - maximum number of keywords to return
+    // Output :- Returns vector of pairs (keyword ID, frequency) sorted by weight descending, limited to 'limit' entries
+    // Sideeffect :- Keeps a bounded heap of 'limit' entries
+    // Assumption :- weight and freq have the same size, zero weights are skipped, every ID with a non-zero weight is in vocab
+    std::vector<std::pair<TokenId, std::size_t>> topKeywords(
+        const std::vector<float>& weight, const std::vector<std::uint32_t>& freq,
+        const Vocabulary& vocab, std::size_t limit) const;
 };
 
 #endif 
@@ -0,0 +1,130 @@
+#ifndef KEYWORD_SKETCH_H
+#define KEYWORD_SKETCH_H
+
+#include "document.h"
+#include "flat_hash_map.h"
+#include "vocabulary.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Objective :- Class counting token frequencies approximately in a fixed amount of memory, for corpora whose long-tail vocabulary is too large to count exactly.
+//              Space-Saving keeps the heavy hitters (top keywords); Count-Min answers frequency queries for any token (used to score lines).
+//              Error bounds for N counted tokens, k Space-Saving counters, Count-Min width w and depth d:
+//              - Count-Min never underestimates; it overestimates by at most (e / w) * N with probability at least 1 - e^-d
+//              - Space-Saving overestimates each kept count by at most N / k, and keeps every token that occurs more than N / k times
+//              Both keep 32-bit counts that saturate at 2^32 - 1 rather than wrap, so tokens seen more often than that tie at the maximum
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class KeywordSketch {
+public:
+    // Objective :- Create an empty sketch sized to a memory budget (a quarter for Space-Saving counters, the rest for the Count-Min table)
+    // Input :- memoryBudget - bytes the sketch may use
+    // Output :- None (constructor)
+    // Sideeffect :- Allocates the Count-Min table and reserves the counters
+    // Assumption :- None (tiny budgets are raised to a small minimum)
+    explicit KeywordSketch(std::size_t memoryBudget);
+
+    // Objective :- Count occurrences of one token
+    // Input :- token - token text, count - number of occurrences
+    // Output :- None (void function)
+    // Sideeffect :- Updates the Count-Min table and the Space-Saving counters (may evict the smallest counter)
+    // Assumption :- count > 0; distinct tokens have distinct 64-bit hashes
+    void add(std::string_view token, std::uint32_t count = 1);
+
+    // Objective :- Count the tokens of a batch of lines whose token IDs refer to a batch-local vocabulary
+    // Input :- lines - processed lines, local - vocabulary the line tokens refer to
+    // Output :- None (void function)
+    // Sideeffect :- Counts each distinct token of the batch once with its batch count
+    // Assumption :- Every token ID in lines is in local
+    void accumulate(const std::vector<ProcessedLine>& lines, const Vocabulary& local);
+
+    // Objective :- Estimate how often a token occurred (Count-Min point query)
+    // Input :- token - token text
+    // Output :- Returns an estimate that is never below the true count (see the class comment for the upper bound)
+    // Sideeffect :- None
+    // Assumption :- None
+    std::uint32_t estimate(std::string_view token) const;
+
+    // Objective :- Report the largest Space-Saving count, an upper bound of the most frequent token's count used to normalize scores
+    // Input :- None
+    // Output :- Returns the largest counter value (0 if nothing was counted)
+    // Sideeffect :- None
+    // Assumption :- None
+    std::uint32_t maxCount() const;
+
+    // Objective :- Extract the top keywords from the Space-Saving counters, sorted by count (descending), then alphabetically for ties
+    // Input :- vocab - vocabulary the selected keywords are interned into, limit - maximum number of keywords to return
+    // Output :- Returns vector of pairs (keyword ID, estimated count), limited to 'limit' entries
+    // Sideeffect :- Interns only the selected keywords into vocab
+    // Assumption :- None
+    std::vector<std::pair<TokenId, std::size_t>> topKeywords(Vocabulary& vocab, std::size_t limit) const;
+
+    // Objective :- Report the number of token occurrences counted so far (N in the error bounds)
+    // Input :- None
+    // Output :- Returns total count
+    // Sideeffect :- None
+    // Assumption :- None
+    std::uint64_t total() const;
+
+    // Objective :- Report the Count-Min error factor e / w (estimates exceed true counts by at most epsilon() * total() with probability 1 - delta())
+    // Input :- None
+    // Output :- Returns epsilon
+    // Sideeffect :- None
+    // Assumption :- None
+    double epsilon() const;
+
+    // Objective :- Report the probability e^-d that a Count-Min estimate exceeds its bound
+    // Input :- None
+    // Output :- Returns delta
+    // Sideeffect :- None
+    // Assumption :- None
+    double delta() const;
+
+    // Objective :- Report the number of Space-Saving counters k (kept counts overestimate by at most total() / k)
+    // Input :- None
+    // Output :- Returns k
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t capacity() const;
+
+private:
+    // Objective :- Represents one Space-Saving counter
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct Counter {
+        std::string token;          // Token text
+        std::uint64_t hash{};       // Hash of the token
+        std::uint32_t count{};      // Estimated count (true count plus at most 'error', saturating at 2^32 - 1)
+        std::uint32_t error{};      // Count inherited from the evicted counter
+    };
+
+    std::size_t depth;                                      // Count-Min rows
+    std::size_t widthMask;                                  // Count-Min columns - 1 (columns are a power of two)
+    std::vector<std::uint32_t> table;                       // Count-Min table, depth rows of width counters
+    std::size_t slots;                                      // Space-Saving capacity k
+    std::vector<Counter> counters;                          // Space-Saving counters as a min-heap on count
+    FlatHashMap<std::uint64_t, std::uint32_t> index;        // Token hash -> position of its counter in the heap
+    std::uint64_t tokens = 0;                               // Occurrences counted
+
+    // Objective :- Restore the heap order after the counter at position i grew
+    // Input :- i - heap position
+    // Output :- None (void function)
+    // Sideeffect :- Swaps counters downwards and updates their positions in index
+    // Assumption :- Only counters[i] may be out of order
+    void siftDown(std::size_t i);
+
+    // Objective :- Restore the heap order after a counter was appended at position i
+    // Input :- i - heap position
+    // Output :- None (void function)
+    // Sideeffect :- Swaps counters upwards and updates their positions in index
+    // Assumption :- Only counters[i] may be out of order
+    void siftUp(std::size_t i);
+};
+
+#endif
@@ -1,26 +1,234 @@
 #ifndef LINE_SCORER_H
 #define LINE_SCORER_H
 
+#include "corpus.h"
 #include "document.h"
-#include <string>
-#include <unordered_map>
+#include "options.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <variant>
 #include <vector>
 
-// Objective :- Class for scoring processed lines based on keyword frequency and line length
-// Input :- None (class declaration)
-// Output :- None (class declaration)
+// Objective :- Represents the corpus-wide figures a scoring policy may depend on
+// Input :- None (data structure)
+// Output :- None (data structure)
 // Sideeffect :- None
-class LineScorer {
+struct LineStats {
+    double averageTokens{};      // Average number of tokens per line
+};
+
+// Objective :- Scoring policy of the original formula: 80% keyword density (normalized weight per token) plus 20% length bonus (full at 20 tokens)
+// Input :- None (policy declaration)
+// Output :- None (policy declaration)
+// Sideeffect :- None
+struct DensityPolicy {
+    explicit DensityPolicy(const LineStats&) {}
+
+    // Objective :- Score one line
+    // Input :- weightSum - sum of the normalized weights of the line's tokens, tokens - number of tokens (> 0)
+    // Output :- Returns the line score
+    // Sideeffect :- None
+    // Assumption :- None
+    float operator()(float weightSum, std::size_t tokens) const {
+        // Calculate keyword density (score per token)
+        double density = weightSum / static_cast<double>(tokens);
+        // Calculate length bonus (capped at 1.0 for lines with 20+ tokens)
+        double lengthBonus = std::min(1.0, (double)tokens / 20.0);
+        // Final score: 80% density + 20% length bonus
+        return static_cast<float>(density * 0.8 + lengthBonus * 0.2);
+    }
+
+    bool operator==(const DensityPolicy&) const { return true; }   // Scores do not depend on LineStats
+};
+
+// Objective :- Scoring policy of Okapi BM25 with each line as a document and the normalized token weights as query term weights (k1 = 1.2, b = 0.75); every occurrence counts as one term match, since lines rarely repeat a word
+// Input :- None (policy declaration)
+// Output :- None (policy declaration)
+// Sideeffect :- None
+struct Bm25Policy {
+    explicit Bm25Policy(const LineStats& stats) : averageTokens(stats.averageTokens > 0 ? stats.averageTokens : 1.0) {}
+
+    // Objective :- Score one line: weightSum * (k1 + 1) / (1 + k1 * (1 - b + b * tokens / averageTokens))
+    // Input :- weightSum - sum of the normalized weights of the line's tokens, tokens - number of tokens (> 0)
+    // Output :- Returns the line score
+    // Sideeffect :- None
+    // Assumption :- None
+    float operator()(float weightSum, std::size_t tokens) const {
+        // Longer lines than average saturate, shorter ones are boosted
+        double norm = 1.2 * (0.25 + 0.75 * static_cast<double>(tokens) / averageTokens);
+        return static_cast<float>(weightSum * 2.2 / (1.0 + norm));
+    }
+
+    bool operator==(const Bm25Policy& other) const { return averageTokens == other.averageTokens; }
+
+    double averageTokens;        // Average line length the document-length normalization is relative to
+};
+
+// Objective :- Scoring policy summing the line's token weights (with TF-IDF weights, the line's TF-IDF sum); longer lines score higher
+// Input :- None (policy declaration)
+// Output :- None (policy declaration)
+// Sideeffect :- None
+struct TfidfSumPolicy {
+    explicit TfidfSumPolicy(const LineStats&) {}
+
+    // Objective :- Score one line
+    // Input :- weightSum - sum of the normalized weights of the line's tokens, tokens - number of tokens (unused)
+    // Output :- Returns the line score
+    // Sideeffect :- None
+    // Assumption :- None
+    float operator()(float weightSum, std::size_t) const {
+        return weightSum;
+    }
+
+    bool operator==(const TfidfSumPolicy&) const { return true; }   // Scores do not depend on LineStats
+};
+
+// Objective :- Class for scoring processed lines by the weights of their tokens and their length, optionally on several threads. The formula is a compile-time policy
+//              (DensityPolicy, Bm25Policy, TfidfSumPolicy, or any type with the same members) inlined into the scoring loop; makeLineScorer picks one at run time.
+// Input :- None (class template declaration); Policy - scoring policy
+// Output :- None (class template declaration)
+// Sideeffect :- None
+template <typename Policy>
+class BasicLineScorer {
 public:
     // Objective :- Score each processed line based on keyword frequency and line length, then sort by score descending
-    // Input :- lines - vector of ProcessedLine objects to score, keywordFreq - map of keyword frequencies
-    // Output :- Returns vector of ScoredLine objects sorted by score in descending order
+    // Input :- corpus - processed lines to score (walked one document arena at a time), keywordFreq - frequency of each token ID
+    // Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order, earlier lines first on ties
     // Sideeffect :- Creates and sorts a vector of ScoredLine objects
-    // Assumption :- lines and keywordFreq may be empty, keywordFreq contains at least one entry if not empty
+    // Assumption :- corpus and keywordFreq may be empty, IDs beyond keywordFreq count as zero, the arenas outlive the result
     std::vector<ScoredLine> score(
-        const std::vector<ProcessedLine>& lines,
-        const std::unordered_map<std::string, std::size_t>& keywordFreq) const;
+        const Corpus& corpus,
+        const std::vector<std::uint32_t>& keywordFreq) const;
+
+    // Objective :- score() with caller-supplied normalization figures, for a corpus that is only part of the material (e.g. one streamed batch), so its scores compare with those of the other parts
+    // Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, maxFreq - frequency that normalizes to 1 (the corpus-wide maximum), stats - figures of the whole material (e.g. its average line length)
+    // Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order, earlier lines first on ties
+    // Sideeffect :- Creates and sorts a vector of ScoredLine objects
+    // Assumption :- corpus and keywordFreq may be empty, IDs beyond keywordFreq count as zero, the arenas outlive the result; maxFreq = 0 scores nothing
+    std::vector<ScoredLine> score(
+        const Corpus& corpus,
+        const std::vector<std::uint32_t>& keywordFreq,
+        double maxFreq,
+        const LineStats& stats) const;
+
+    // Objective :- Score each processed line based on keyword weights (e.g. KeywordExtractor::tfidf) and line length, then sort by score descending
+    // Input :- corpus - processed lines to score, keywordWeight - weight of each token ID
+    // Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order, earlier lines first on ties
+    // Sideeffect :- Creates and sorts a vector of ScoredLine objects
+    // Assumption :- corpus and keywordWeight may be empty, IDs beyond keywordWeight count as zero, the arenas outlive the result
+    std::vector<ScoredLine> score(
+        const Corpus& corpus,
+        const std::vector<float>& keywordWeight) const;
+
+    // Objective :- Score every processed line but return only the best 'limit' lines, selected with a bounded heap instead of sorting all of them
+    // Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, limit - number of lines needed (e.g. QuestionGenerator::linesNeeded)
+    // Output :- Returns references (corpus-wide line index and score) to the first 'limit' lines of score(corpus, keywordFreq)
+    // Sideeffect :- Keeps a bounded heap of 'limit' 8-byte references
+    // Assumption :- Same as score()
+    std::vector<ScoredRef> scoreTop(
+        const Corpus& corpus,
+        const std::vector<std::uint32_t>& keywordFreq,
+        std::size_t limit) const;
+
+    // Objective :- scoreTop() with caller-supplied normalization figures (see the matching score() overload)
+    // Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, maxFreq - frequency that normalizes to 1, stats - figures of the whole material, limit - number of lines needed
+    // Output :- Returns references to the first 'limit' lines of score(corpus, keywordFreq, maxFreq, stats)
+    // Sideeffect :- Keeps a bounded heap of 'limit' 8-byte references
+    // Assumption :- Same as score()
+    std::vector<ScoredRef> scoreTop(
+        const Corpus& corpus,
+        const std::vector<std::uint32_t>& keywordFreq,
+        double maxFreq,
+        const LineStats& stats,
+        std::size_t limit) const;
+
+    // Objective :- scoreTop() for keyword weights (see the matching score() overload)
+    // Input :- corpus - processed lines to score, keywordWeight - weight of each token ID, limit - number of lines needed
+    // Output :- Returns references to the first 'limit' lines of score(corpus, keywordWeight)
+    // Sideeffect :- Keeps a bounded heap of 'limit' 8-byte references
+    // Assumption :- Same as score()
+    std::vector<ScoredRef> scoreTop(
+        const Corpus& corpus,
+        const std::vector<float>& keywordWeight,
+        std::size_t limit) const;
+
+    // Objective :- scoreTop() for a corpus that changes by a few documents between calls (e.g. CorpusManifest::lines after a refresh): keeps every line's score, each document's best lines in rank order and a token-to-lines posting index, and rescores only lines that contain a token whose frequency changed or that belong to a new document; all lines are rescored when the largest frequency changes
+    //              or the changed tokens' counts reach a quarter of the lines, and corpora under 256k lines are always scored in full without keeping any state
+    // Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, limit - number of lines needed
+    // Output :- Returns the same references as scoreTop(corpus, keywordFreq, limit)
+    // Sideeffect :- On large corpora, updates the cached scores (4 bytes per line), the per-document best lines and, from the first update that changes few enough lines, the posting index (8 bytes per distinct token of each line); holds the document arenas until the next call.
+    //               On small ones, releases all of that
+    // Assumption :- Documents are recognized by arena, so unchanged documents must be passed as the same arenas (as CorpusManifest does)
+    std::vector<ScoredRef> rescoreTop(
+        const Corpus& corpus,
+        const std::vector<std::uint32_t>& keywordFreq,
+        std::size_t limit);
+
+    // Objective :- Set the number of worker threads used to score large corpora (results do not depend on it)
+    // Input :- count - number of threads (0 means one per hardware thread, 1 scores on the calling thread)
+    // Output :- None (void function)
+    // Sideeffect :- Updates member variable threads
+    // Assumption :- None
+    void setThreads(std::size_t count);
+
+private:
+    // Objective :- Represents one document known to rescoreTop
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct RankedDocument {
+        std::shared_ptr<const DocumentArena> arena;   // Lines of the document (null once it left the corpus)
+        std::size_t first{};                          // Corpus-wide index of its first line in the latest corpus
+        bool indexed{};                               // True once its lines are in the posting index
+        bool stale{};                                 // True when some line needs rescoring or 'best' needs rebuilding
+        std::vector<float> scores;                    // Score of each line (negative for lines without tokens or lines awaiting rescoring)
+        std::vector<ScoredRef> best;                  // Its best lines (index = line within the document) in rank order
+    };
+
+    // Objective :- Represents one line in the posting index
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct LineKey {
+        std::uint32_t doc{};                          // Slot of the document in rankedDocs
+        std::uint32_t line{};                         // Line within the document
+    };
+
+    std::size_t threads = 1;                          // Worker threads for scoring (0 = all cores)
+    std::vector<RankedDocument> rankedDocs;           // Documents seen by rescoreTop, by slot (removed ones stay until removed outnumber live)
+    std::vector<std::uint32_t> rankedFreq;            // Frequencies the cached scores were computed with
+    Policy rankedPolicy{LineStats{}};                 // Policy the cached scores were computed with
+    std::size_t rankedLimit = 0;                      // Number of lines each document's 'best' list was built for
+    std::vector<std::vector<LineKey>> postings;       // Token ID -> lines containing it (entries of removed documents are dropped lazily)
+
+    // Objective :- Add the lines of one document to the posting index
+    // Input :- slot - slot of the document in rankedDocs
+    // Output :- None (void function)
+    // Sideeffect :- Appends one entry per distinct token of each line to postings; marks the document indexed
+    // Assumption :- The document is live and not yet indexed
+    void indexDocument(std::uint32_t slot);
 };
 
+// Definitions live in line_scorer.cpp, instantiated for the built-in policies
+extern template class BasicLineScorer<DensityPolicy>;
+extern template class BasicLineScorer<Bm25Policy>;
+extern template class BasicLineScorer<TfidfSumPolicy>;
+
+using LineScorer = BasicLineScorer<DensityPolicy>;          // Original formula
+using Bm25LineScorer = BasicLineScorer<Bm25Policy>;         // BM25 with line-length normalization
+using TfidfSumLineScorer = BasicLineScorer<TfidfSumPolicy>; // Sum of token weights
+
+// Objective :- Holds one line scorer of the policy chosen at run time; callers std::visit it, so each branch runs a fully specialized scorer without virtual calls
+using AnyLineScorer = std::variant<LineScorer, Bm25LineScorer, TfidfSumLineScorer>;
+
+// Objective :- Create the line scorer for a scoring policy chosen at run time
+// Input :- policy - scoring formula (TextRank gets the density scorer), threads - worker threads for scoring (0 = all cores)
+// Output :- Returns the scorer
+// Sideeffect :- None
+// Assumption :- None
+AnyLineScorer makeLineScorer(ScorePolicy policy, std::size_t threads);
+
 #endif 
 
@@ -0,0 +1,38 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstddef>
+#include <string>
+
+// Objective :- Line scoring formula (see the policies in line_scorer.h and TextRanker)
+enum class ScorePolicy {
+    Density,    // 80% keyword density + 20% length bonus
+    Bm25,       // BM25 with line-length normalization
+    TfidfSum,   // Sum of the line's TF-IDF weights
+    TextRank    // Centrality in the line-similarity graph (Density when streaming)
+};
+
+// Objective :- Represents the command-line settings that tune how the generator loads and processes documents
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct Options {
+    std::size_t threads{};        // Worker threads for parallel stages (0 = one per hardware thread)
+    std::size_t streamBudgetMb{}; // Memory budget in MB for the streaming pipeline (0 = load the whole corpus)
+    std::string stopwordsPath;    // File with extra stopwords added to the built-in list (empty = built-in list only)
+    std::size_t phraseLength{4};  // Longest keyphrase in words (1 = single-word keywords only)
+    std::size_t approxCountsMb{}; // Memory budget in MB for approximate keyword counting when streaming (0 = exact counts)
+    bool tfidf{};                 // Rank keywords and score lines by TF-IDF instead of raw counts (when the whole corpus is loaded)
+    ScorePolicy scoring{ScorePolicy::Density}; // Line scoring formula
+    bool incremental{};           // Keep line scores between runs and rescore only lines whose keyword counts changed (large folders edited a little at a time)
+    bool ok{true};                // False if the command line could not be parsed
+};
+
+// Objective :- Parse command-line arguments into an Options structure
+// Input :- argc - argument count, argv - argument values as passed to main
+// Output :- Returns Options with parsed settings; ok is false on unknown or malformed arguments
+// Sideeffect :- Writes error and usage messages to cerr on invalid arguments
+// Assumption :- argv holds argc valid C strings
+Options parseOptions(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+// Objective :- Namespace containing helpers for running independent tasks on a pool of worker threads
+// Input :- None (namespace declaration)
+// Output :- None (namespace declaration)
+// Sideeffect :- None
+namespace parallel {
+    // Objective :- Resolve a requested thread count, mapping 0 to the number of hardware threads
+    // Input :- requested - desired number of threads (0 means "use all cores")
+    // Output :- Returns number of threads to use (at least 1)
+    // Sideeffect :- Queries hardware concurrency
+    // Assumption :- None
+    std::size_t resolveThreads(std::size_t requested);
+
+    // Objective :- Run task(i) for every i in [0, count) on up to 'threads' workers that pull indices from a shared counter
+    // Input :- count - number of tasks, threads - number of worker threads (0 means all cores), task - function called with each task index
+    // Output :- None (void function)
+    // Sideeffect :- Starts and joins worker threads (runs inline when one thread is enough)
+    // Assumption :- task is safe to call concurrently for distinct indices and does not throw
+    void forEach(std::size_t count, std::size_t threads, const std::function<void(std::size_t)>& task);
+
+    // Objective :- Like forEach, but also tell each task which worker runs it, so workers can reuse per-worker scratch space
+    // Input :- count - number of tasks, threads - number of worker threads (0 means all cores), task - function called with each task index and the worker index
+    // Output :- None (void function)
+    // Sideeffect :- Starts and joins worker threads (runs inline when one thread is enough)
+    // Assumption :- task is safe to call concurrently for distinct indices and does not throw; worker indices are below resolveThreads(threads) and one worker runs one task at a time
+    void forEachWorker(std::size_t count, std::size_t threads, const std::function<void(std::size_t, std::size_t)>& task);
+}
+
+#endif
@@ -1,82 +1,121 @@
 #ifndef PREPROCESSOR_H
 #define PREPROCESSOR_H
 
+#include "corpus.h"
 #include "document.h"
+#include "stopword_table.h"
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
-// Objective :- Class for preprocessing text: normalizing, tokenizing, and removing stopwords from documents
+// Objective :- Class for preprocessing text: normalizing, tokenizing, removing stopwords and interning the remaining tokens into a shared Vocabulary
 // Input :- None (class declaration)
 // Output :- None (class declaration)
 // Sideeffect :- None
 class Preprocessor {
 public:
-    // Objective :- Initialize Preprocessor with a set of stopwords for text filtering
-    // Input :- None
+    // Objective :- Initialize Preprocessor with the stopwords to filter out and the vocabulary tokens are interned into
+    // Input :- vocab - vocabulary receiving the token IDs, stopwords - stopword table (built-in English list by default)
     // Output :- None (constructor)
-    // Sideeffect :- Calls buildStopwords() to populate stopwords member variable
-    // Assumption :- None
-    Preprocessor();
+    // Sideeffect :- Copies the stopword table, stores a reference to vocab
+    // Assumption :- vocab outlives the preprocessor
+    explicit Preprocessor(Vocabulary& vocab, const StopwordTable& stopwords = StopwordTable());
     
-    // Objective :- Process a single line of text: normalize, tokenize, and remove stopwords
-    // Input :- line - string containing raw text line to process
-    // Output :- Returns ProcessedLine object containing original line, cleaned text, and filtered tokens
-    // Sideeffect :- Creates ProcessedLine object and processes text
-    // Assumption :- line is a valid string, may be empty
-    ProcessedLine process(const std::string& line) const;
+    // Objective :- Process a single line of text: normalize, tokenize, remove stopwords and intern the remaining tokens
+    // Input :- line - view of the raw text line to process (may point into a mapped file)
+    // Output :- Returns ProcessedLine object containing original line, cleaned text, and filtered token IDs
+    // Sideeffect :- Creates ProcessedLine object and processes text, interns new tokens into the vocabulary
+    // Assumption :- line is a valid string, may be empty; not called concurrently (the vocabulary is not thread-safe)
+    ProcessedLine process(std::string_view line);
+
+    // Objective :- Process a single line into caller-owned buffers: normalize it and collect its non-stopword tokens as views, without heap allocation once the buffers have grown
+    // Input :- line - view of the raw text line, cleaned - string receiving the normalized text, tokens - vector receiving views of the tokens
+    // Output :- None (void function)
+    // Sideeffect :- Overwrites cleaned, clears tokens and fills it with views into cleaned
+    // Assumption :- line does not point into cleaned; the token views are valid until cleaned is next modified
+    void process(std::string_view line, std::string& cleaned, std::vector<std::string_view>& tokens) const;
     
     // Objective :- Process all lines in a document, filtering out lines with no tokens after stopword removal
     // Input :- doc - Document object containing lines to process
     // Output :- Returns vector of ProcessedLine objects (only lines with tokens)
-    // Sideeffect :- Creates vector and processes each line
-    // Assumption :- doc contains valid lines vector, may be empty
-    std::vector<ProcessedLine> process(const Document& doc) const;
+    // Sideeffect :- Creates vector and processes each line, interns new tokens into the vocabulary
+    // Assumption :- doc contains valid lines vector, may be empty; not called concurrently
+    std::vector<ProcessedLine> process(const Document& doc);
     
+    // Objective :- Process a sequence of raw lines, filtering out lines with no tokens after stopword removal
+    // Input :- lines - views of the raw text lines to process
+    // Output :- Returns vector of ProcessedLine objects (only lines with tokens)
+    // Sideeffect :- Creates vector and processes each line, interns new tokens into the vocabulary
+    // Assumption :- Views remain valid during the call; not called concurrently
+    std::vector<ProcessedLine> process(const std::vector<std::string_view>& lines);
+
     // Objective :- Process all documents and combine their processed lines into a single vector
     // Input :- docs - vector of Document objects to process
     // Output :- Returns vector of ProcessedLine objects from all documents combined
-    // Sideeffect :- Creates vector and processes all documents
-    // Assumption :- docs vector may be empty, each document is valid
-    std::vector<ProcessedLine> process(const std::vector<Document>& docs) const;
-    
-    // Objective :- Collect all tokens from all processed lines into a single flat vector
-    // Input :- lines - vector of ProcessedLine objects containing tokens
-    // Output :- Returns vector of all tokens from all lines
-    // Sideeffect :- Creates new vector and copies tokens
-    // Assumption :- lines vector may be empty, each ProcessedLine contains valid tokens
-    std::vector<std::string> collectTokens(const std::vector<ProcessedLine>& lines) const;
+    // Sideeffect :- Creates vector and processes all documents, interns new tokens into the vocabulary
+    // Assumption :- docs vector may be empty, each document is valid; not called concurrently
+    std::vector<ProcessedLine> process(const std::vector<Document>& docs);
+
+    // Objective :- Process documents on several threads straight into document arenas, one corpus per document, with the lines (token IDs included) of calling process(doc) for each document in order
+    // Input :- docs - documents to process, threads - number of worker threads (0 = all cores)
+    // Output :- Returns vector whose element i holds the processed lines of docs[i] (only lines with tokens), one arena per chunk of the document
+    // Sideeffect :- Splits documents into chunks processed in parallel against task-local vocabularies, each appended line by line into its own arena through reused buffers,
+    //               then interns the chunk vocabularies into the shared vocabulary in document order and rewrites the arenas' token IDs
+    // Assumption :- Documents stay valid during the call; not called concurrently
+    std::vector<Corpus> processEach(const std::vector<Document>& docs, std::size_t threads);
+
+    // Objective :- Multi-threaded process(docs): process documents across cores and combine their lines in document order
+    // Input :- docs - documents to process, threads - number of worker threads (0 = all cores)
+    // Output :- Returns vector of ProcessedLine objects from all documents combined, identical to process(docs)
+    // Sideeffect :- Runs processEach() and copies its lines out of the arenas into one vector
+    // Assumption :- Documents stay valid during the call; not called concurrently
+    std::vector<ProcessedLine> process(const std::vector<Document>& docs, std::size_t threads);
+
+    // Objective :- First half of process() that does not touch the vocabulary: copy and normalize each line, leaving tokens empty
+    // Input :- lines - views of the raw text lines
+    // Output :- Returns one ProcessedLine per input line with original and cleaned text filled in
+    // Sideeffect :- Creates vector and copies text
+    // Assumption :- Views remain valid during the call; safe to call concurrently
+    std::vector<ProcessedLine> normalizeLines(const std::vector<std::string_view>& lines) const;
+
+    // Objective :- Second half of process(): tokenize the cleaned text of each line, intern its tokens and drop lines without tokens
+    // Input :- lines - lines produced by normalizeLines()
+    // Output :- None (void function)
+    // Sideeffect :- Fills tokens of every line, erases lines with no tokens, interns new tokens into the vocabulary
+    // Assumption :- Not called concurrently
+    void internTokens(std::vector<ProcessedLine>& lines);
+
+    // Objective :- internTokens() against a given vocabulary, e.g. a batch-local one that is dropped after the batch so the shared vocabulary does not grow
+    // Input :- lines - lines produced by normalizeLines(), target - vocabulary the tokens are interned into
+    // Output :- None (void function)
+    // Sideeffect :- Fills tokens of every line, erases lines with no tokens, interns new tokens into target
+    // Assumption :- target is not used concurrently by another thread
+    void internTokens(std::vector<ProcessedLine>& lines, Vocabulary& target) const;
 
 private:
-    std::unordered_set<std::string> stopwords;  // Set of stopwords to filter out during processing
+    Vocabulary& vocab;                               // Vocabulary that tokens are interned into
+    StopwordTable stopwords;                         // Perfect-hash table of stopwords to filter out during processing
     
-    // Objective :- Build and return a set of common English stopwords to filter out during text processing
-    // Input :- None
-    // Output :- Returns unordered_set containing common stopwords
-    // Sideeffect :- Creates and returns a set
-    // Assumption :- None
-    static std::unordered_set<std::string> buildStopwords();
+    // Objective :- Normalize text by converting to lowercase and replacing non-alphanumeric characters with spaces (vectorized, see simd::normalizeAscii)
+    // Input :- line - view of the text to normalize, out - string receiving the normalized text (its capacity is reused)
+    // Output :- None (void function)
+    // Sideeffect :- Resizes out to the length of line and overwrites its contents
+    // Assumption :- line does not point into out
+    static void normalize(std::string_view line, std::string& out);
     
-    // Objective :- Normalize text by converting to lowercase and replacing non-alphanumeric characters with spaces
-    // Input :- line - string containing text to normalize
-    // Output :- Returns normalized string with lowercase letters/numbers and spaces only
-    // Sideeffect :- Creates new string
-    // Assumption :- line is a valid string, may be empty
-    static std::string normalize(const std::string& line);
-    
-    // Objective :- Split text into individual word tokens separated by whitespace
-    // Input :- text - string containing text to tokenize
-    // Output :- Returns vector of strings, each string is a token (word)
-    // Sideeffect :- Creates string stream and vector
-    // Assumption :- text is a valid string, may be empty or contain only whitespace
-    static std::vector<std::string> tokenize(const std::string& text);
-    
-    // Objective :- Filter out stopwords from token vector, keeping only meaningful words
-    // Input :- tokens - vector of strings containing tokens to filter
-    // Output :- Returns vector of tokens with stopwords removed
-    // Sideeffect :- Creates new vector
-    // Assumption :- tokens vector may be empty, stopwords member variable is initialized
-    std::vector<std::string> removeStopWords(const std::vector<std::string>& tokens) const;
+    // Objective :- Process one line against a given vocabulary (the shared one, or a task-local one in processEach())
+    // Input :- line - view of the raw text line, target - vocabulary the tokens are interned into, views - scratch vector for token views
+    // Output :- Returns ProcessedLine object with original line, cleaned text and token IDs from target
+    // Sideeffect :- Interns new tokens into target, overwrites views
+    // Assumption :- target is not used concurrently by another thread
+    ProcessedLine processLine(std::string_view line, Vocabulary& target, std::vector<std::string_view>& views) const;
+
+    // Objective :- Split normalized text into whitespace-separated tokens in place, dropping stopwords on the fly
+    // Input :- text - normalized text to scan, out - vector receiving views of the kept tokens
+    // Output :- None (void function)
+    // Sideeffect :- Appends views into text to out
+    // Assumption :- text is normalized (only lowercase alphanumerics and whitespace remain), stopwords member variable is initialized
+    void tokenize(std::string_view text, std::vector<std::string_view>& out) const;
 };
 
 #endif 
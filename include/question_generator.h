@@ -1,9 +1,13 @@
 #ifndef QUESTION_GENERATOR_H
 #define QUESTION_GENERATOR_H
 
+#include "corpus.h"
 #include "document.h"
+#include "flat_hash_map.h"
+#include "vocabulary.h"
 #include <random>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -24,35 +28,95 @@ public:
                       std::size_t longCount = 3);
     
     // Objective :- Generate a complete question paper with MCQs, fill-in-blanks, short questions, and long questions from scored lines and keywords
-    // Input :- lines - vector of ScoredLine objects (sorted by score), keywords - vector of keyword-frequency pairs
+    // Input :- lines - vector of ScoredLine objects (sorted by score), keywords - vector of keyword ID-frequency pairs, vocab - vocabulary used to render keywords as text
     // Output :- Returns QuestionPaper object containing all generated questions
     // Sideeffect :- Creates QuestionPaper object, generates random numbers, may skip questions if generation fails
-    // Assumption :- lines and keywords may be empty, lines are sorted by score descending, keywords are sorted by frequency
+    // Assumption :- lines and keywords may be empty, lines are sorted by score descending, keywords are sorted by frequency, all IDs are in vocab
     QuestionPaper generate(const std::vector<ScoredLine>& lines,
-                           const std::vector<std::pair<std::string, std::size_t>>& keywords) const;
+                           const std::vector<std::pair<TokenId, std::size_t>>& keywords,
+                           const Vocabulary& vocab) const;
+
+    // Objective :- Generate a question paper whose keywords may be multi-word phrases (e.g. from KeyphraseExtractor)
+    // Input :- lines - vector of ScoredLine objects (sorted by score), keywords - vector of (keyword or phrase with words separated by spaces, frequency) pairs in rank order, vocab - vocabulary used to map words to token IDs
+    // Output :- Returns QuestionPaper object containing all generated questions
+    // Sideeffect :- Creates QuestionPaper object, generates random numbers, may skip questions if generation fails
+    // Assumption :- lines and keywords may be empty, lines are sorted by score descending; entries with words missing from vocab (e.g. stopwords) are ignored
+    QuestionPaper generate(const std::vector<ScoredLine>& lines,
+                           const std::vector<std::pair<std::string, std::size_t>>& keywords,
+                           const Vocabulary& vocab) const;
+
+    // Objective :- Generate a question paper from compact line references (e.g. LineScorer::scoreTop) instead of line views
+    // Input :- corpus - corpus the references index into, lines - scored references sorted by score, keywords - vector of (keyword or phrase, frequency) pairs in rank order, vocab - vocabulary used to map words to token IDs
+    // Output :- Returns QuestionPaper object containing all generated questions
+    // Sideeffect :- Resolves only the first linesNeeded() references into views, then as generate(lines, keywords, vocab)
+    // Assumption :- Every index is below corpus.size(); otherwise as generate(lines, keywords, vocab)
+    QuestionPaper generate(const Corpus& corpus,
+                           const std::vector<ScoredRef>& lines,
+                           const std::vector<std::pair<std::string, std::size_t>>& keywords,
+                           const Vocabulary& vocab) const;
+
+    // Objective :- Report how many of the best-scoring lines generate() can use
+    // Input :- None
+    // Output :- Returns the largest of the MCQ, fill-in-blank and long question counts
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t linesNeeded() const;
 
 private:
     std::size_t mcqCount;      // Number of multiple choice questions to generate
     std::size_t fillCount;     // Number of fill-in-blank questions to generate
     std::size_t shortCount;    // Number of short answer questions to generate
     std::size_t longCount;     // Number of long answer questions to generate
+
+    // Objective :- Represents one keyword or keyphrase as matched against lines
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct Term {
+        std::vector<TokenId> ids;  // Token IDs of the words, in order
+        std::string text;          // Words separated by single spaces
+    };
+
+    // Objective :- Represents the lookups over one paper's terms, built once per paper instead of once per question
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct TermIndex {
+        FlatHashMap<TokenId, std::vector<std::size_t>> byFirst;   // First token ID -> terms starting with it, in rank order
+        std::vector<std::vector<std::size_t>> byLength;           // Number of words -> terms with that many words, in rank order
+    };
+
+    // Objective :- Index terms by their first token ID and by their number of words
+    // Input :- terms - keywords and keyphrases in rank order
+    // Output :- Returns the index
+    // Sideeffect :- Allocates one list entry per term in each lookup
+    // Assumption :- Every term has at least one token ID
+    static TermIndex indexTerms(const std::vector<Term>& terms);
+
+    // Objective :- Generate the question paper from keywords already resolved to token ID sequences
+    // Input :- lines - vector of ScoredLine objects (sorted by score), terms - keywords and keyphrases in rank order
+    // Output :- Returns QuestionPaper object containing all generated questions
+    // Sideeffect :- Creates QuestionPaper object, generates random numbers, may skip questions if generation fails
+    // Assumption :- lines and terms may be empty, every term has at least one token ID
+    QuestionPaper generateTerms(const std::vector<ScoredLine>& lines, const std::vector<Term>& terms) const;
     
     // Objective :- Build a multiple choice question from a scored line by finding a keyword and creating options with distractors
-    // Input :- line - ScoredLine object containing processed line, keywords - vector of keyword strings, rng - random number generator reference
+    // Input :- line - ScoredLine object containing processed line, keywords - keywords and keyphrases in rank order, index - indexTerms(keywords), rng - random number generator reference
     // Output :- Returns MCQ object with prompt, options, and correct answer
-    // Sideeffect :- Shuffles distractors and options, throws exception if keyword not found or insufficient distractors
+    // Sideeffect :- Draws 3 distractors without replacement (O(1) per draw), shuffles options, throws exception if keyword not found or insufficient distractors
     // Assumption :- line contains tokens, keywords vector has at least 4 entries, rng is initialized
     static MCQ buildMcq(const ScoredLine& line,
-                        const std::vector<std::string>& keywords,
+                        const std::vector<Term>& keywords,
+                        const TermIndex& index,
                         std::mt19937& rng);
     
     // Objective :- Build a fill-in-the-blank question by finding a keyword in the line and masking it
-    // Input :- line - ScoredLine object containing processed line, keywords - vector of keyword strings to search for
+    // Input :- line - ScoredLine object containing processed line, keywords - keywords and keyphrases to search for, in rank order
     // Output :- Returns string containing question with masked keyword, or empty string if no keyword found
     // Sideeffect :- None
     // Assumption :- line contains valid tokens, keywords vector may be empty
     static std::string buildFillBlank(const ScoredLine& line,
-                                      const std::vector<std::string>& keywords);
+                                      const std::vector<Term>& keywords);
     
     // Objective :- Generate a short answer question prompt asking to explain a keyword concept
     // Input :- keyword - string containing keyword to ask about
@@ -65,22 +129,22 @@ private:
     // Input :- line - ScoredLine object containing original line text
     // Output :- Returns formatted long question string
     // Sideeffect :- Creates string stream
-    // Assumption :- line.line.original contains valid text
+    // Assumption :- line.line.original views valid text
     static std::string buildLongQuestion(const ScoredLine& line);
     
-    // Objective :- Check if a processed line contains a specific keyword in its tokens
-    // Input :- line - ProcessedLine object containing tokens, kw - string keyword to search for
+    // Objective :- Check if a processed line contains a keyword or keyphrase as consecutive tokens
+    // Input :- line - view of a processed line containing token IDs, kw - token IDs of the keyword to search for
     // Output :- Returns true if keyword found in tokens, false otherwise
     // Sideeffect :- None
-    // Assumption :- line.tokens vector is valid, kw is a valid string
-    static bool containsKeyword(const ProcessedLine& line, const std::string& kw);
+    // Assumption :- line views valid storage
+    static bool containsKeyword(const LineView& line, const std::vector<TokenId>& kw);
     
-    // Objective :- Remove (mask) a keyword from text by finding it case-insensitively and deleting it
-    // Input :- text - string containing original text, keyword - string keyword to remove
-    // Output :- Returns text string with keyword removed, or original text if keyword not found
-    // Sideeffect :- Creates lowercase copies of strings
-    // Assumption :- text and keyword are valid strings, keyword may appear in text
-    static std::string maskKeyword(const std::string& text, const std::string& keyword);
+    // Objective :- Remove (mask) a keyword or keyphrase from the original text, locating it case-insensitively through the cleaned text
+    // Input :- line - view of the processed line (cleaned text is aligned byte for byte with the original), keyword - words separated by single spaces
+    // Output :- Returns original text with keyword removed, or empty string if keyword not found
+    // Sideeffect :- Creates a copy of the original text
+    // Assumption :- keyword is lowercase alphanumeric words; in the text the words may be separated by any run of whitespace or punctuation
+    static std::string maskKeyword(const LineView& line, const std::string& keyword);
 };
 
 #endif 
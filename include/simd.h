@@ -0,0 +1,62 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Objective :- Namespace containing vectorized text and scoring kernels with runtime CPU dispatch (AVX2, SSE2, scalar fallback)
+// Input :- None (namespace declaration)
+// Output :- None (namespace declaration)
+// Sideeffect :- None
+namespace simd {
+    // Objective :- Identifies one kernel family, so tools can check and time the kernels against each other
+    enum class Kernel {
+        Scalar,     // Portable loop (also the tail of the vector kernels)
+        Sse2,       // 16 bytes per step
+        Avx2        // 32 bytes (8 gathered weights) per step
+    };
+
+    // Objective :- Report whether a kernel family can run on this build and CPU
+    // Input :- kernel - kernel family
+    // Output :- Returns true if the kernel is compiled in and the CPU supports it
+    // Sideeffect :- Queries CPU features on first call
+    // Assumption :- None
+    bool supports(Kernel kernel);
+
+    // Objective :- Report whether the running CPU supports AVX2
+    // Input :- None
+    // Output :- Returns true if AVX2 kernels can be used
+    // Sideeffect :- Queries CPU features on first call
+    // Assumption :- None
+    bool hasAvx2();
+
+    // Objective :- Lowercase ASCII letters and map every byte that is neither alphanumeric nor whitespace to a space, 16-32 bytes at a time. Output is byte-identical to applying std::isalnum/std::isspace/std::tolower of the "C" locale per byte.
+    // Input :- in - source bytes, n - number of bytes, out - destination with room for n bytes
+    // Output :- None (void function)
+    // Sideeffect :- Writes n bytes to out
+    // Assumption :- in and out do not overlap partially (in == out is allowed)
+    void normalizeAscii(const char* in, std::size_t n, char* out);
+
+    // Objective :- normalizeAscii() with a chosen kernel instead of the widest one the CPU supports
+    // Input :- kernel - kernel family, in - source bytes, n - number of bytes, out - destination with room for n bytes
+    // Output :- None (void function)
+    // Sideeffect :- Writes n bytes to out
+    // Assumption :- supports(kernel); in and out do not overlap partially
+    void normalizeAscii(Kernel kernel, const char* in, std::size_t n, char* out);
+
+    // Objective :- Sum the token weights of each line in a block of lines stored back to back (8 IDs per gather with AVX2, a masked gather for each line's tail), clamping IDs past the table to its zero sentinel
+    // Input :- weights - weight table of limit + 1 entries, limit - index of the sentinel entry, ids - token column, offsets - start of each line's tokens in ids (lines + 1 entries, the last one marks the end), lines - number of lines, sums - output, one entry per line
+    // Output :- None (void function)
+    // Sideeffect :- Writes sums[l] = sum of weights[min(ids[i], limit)] over line l's tokens, in single precision (summation order differs between kernels, so results agree within float rounding)
+    // Assumption :- weights[limit] == 0; limit < 2^31 (the AVX2 gather uses signed 32-bit indices); offsets are non-decreasing
+    void lineSums(const float* weights, std::uint32_t limit, const std::uint32_t* ids, const std::uint32_t* offsets, std::size_t lines, float* sums);
+
+    // Objective :- lineSums() with a chosen kernel instead of the widest one the CPU supports (SSE2 has no gather and runs the scalar loop)
+    // Input :- kernel - kernel family; the rest as lineSums()
+    // Output :- None (void function)
+    // Sideeffect :- Writes one sum per line
+    // Assumption :- supports(kernel); as lineSums()
+    void lineSums(Kernel kernel, const float* weights, std::uint32_t limit, const std::uint32_t* ids, const std::uint32_t* offsets, std::size_t lines, float* sums);
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef STOPWORD_TABLE_H
+#define STOPWORD_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Objective :- Class answering "is this token a stopword?" with one hash, one table probe and one string compare.
+//              The built-in English list is a perfect-hash table computed at compile time; custom lists loaded
+//              from a file are compiled into a perfect-hash table (hash and displace) when they are loaded.
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class StopwordTable {
+public:
+    // Objective :- Create a table holding only the built-in stopwords
+    // Input :- None
+    // Output :- None (constructor)
+    // Sideeffect :- None (the built-in table is a compile-time constant)
+    // Assumption :- None
+    StopwordTable() = default;
+
+    // Objective :- Add the words of a stopword file to the table and rebuild the perfect hash over built-in and custom words
+    // Input :- path - path to a text file with stopwords separated by whitespace; lines starting with '#' are comments
+    // Output :- Returns true on success, false if the file cannot be read or its words cannot be compiled into a table (the table is then left as it was)
+    // Sideeffect :- Reads the file, rebuilds the runtime table, writes error message to cerr on failure
+    // Assumption :- Words are normalized like document text (lowercased, other punctuation splits words), so they match the tokens they are meant to remove
+    bool loadFile(const std::string& path);
+
+    // Objective :- Check whether a token is a stopword
+    // Input :- token - normalized token (lowercase alphanumerics)
+    // Output :- Returns true if token is in the table
+    // Sideeffect :- None
+    // Assumption :- None
+    bool contains(std::string_view token) const;
+
+    // Objective :- Report the number of stopwords in the table
+    // Input :- None
+    // Output :- Returns the number of distinct stopwords
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t size() const;
+
+    // Objective :- Check whether a token is one of the built-in stopwords using the compile-time table
+    // Input :- token - normalized token
+    // Output :- Returns true if token is a built-in stopword
+    // Sideeffect :- None
+    // Assumption :- None
+    static bool isBuiltIn(std::string_view token);
+
+private:
+    std::vector<std::string> words;           // Distinct stopwords (built-in and custom) once a file is loaded, empty otherwise
+    std::vector<std::uint32_t> seeds;         // Per-bucket displacement seed of the runtime perfect hash
+    std::vector<std::uint32_t> slots;         // Runtime table: word index + 1 per slot, 0 for empty slots
+    std::uint64_t slotMask = 0;               // Table size - 1 (table size is a power of two)
+
+    // Objective :- Compile the words into a perfect-hash table, growing the table until every bucket finds a seed
+    // Input :- None
+    // Output :- Returns true on success, false if two words share a 64-bit hash (no seed can separate them) or the table stops fitting after kMaxDoublings doublings
+    // Sideeffect :- Fills seeds, slots and slotMask (left partly filled on failure), writes the colliding words to cerr
+    // Assumption :- words is non-empty, sorted and free of duplicates
+    bool build();
+};
+
+#endif
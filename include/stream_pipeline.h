@@ -0,0 +1,72 @@
+#ifndef STREAM_PIPELINE_H
+#define STREAM_PIPELINE_H
+
+#include "document.h"
+#include "file_manager.h"
+#include "keyword_extractor.h"
+#include "keyword_sketch.h"
+#include "preprocessor.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Objective :- Class running load, preprocessing and consumption as overlapping stages connected by bounded queues, with the text in flight capped by a memory budget
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class StreamPipeline {
+public:
+    // Objective :- Summary of one pipeline run
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct Stats {
+        std::size_t batches{};     // Number of line batches streamed
+        std::size_t lines{};       // Number of processed lines handed to the consumer
+        std::size_t bytes{};       // Raw text bytes streamed
+        std::size_t peakBytes{};   // Highest estimated memory held by batches in flight
+        double seconds{};          // Wall-clock time of the run
+    };
+
+    // Objective :- Initialize the pipeline with a preprocessor, a memory budget and a worker count
+    // Input :- pre - preprocessor used by the worker and consumer stages, memoryBudget - cap in bytes on batches in flight, threads - preprocessing workers (0 = all cores)
+    // Output :- None (constructor)
+    // Sideeffect :- Stores settings and derives the batch size from the budget
+    // Assumption :- pre outlives the pipeline and is not used elsewhere while a run is in progress
+    StreamPipeline(Preprocessor& pre, std::size_t memoryBudget, std::size_t threads = 0);
+
+    // Objective :- Stream all input files through preprocessing and hand each processed batch to a consumer in load order
+    // Input :- fm - file manager describing the inputs, consume - callback run on the calling thread for every processed batch, stats - optional pointer receiving run statistics, intern - false to hand over normalized lines without tokens (the consumer interns them itself, e.g. into a batch-local vocabulary)
+    // Output :- Returns false if the input path is invalid, true otherwise
+    // Sideeffect :- Starts a loader thread and worker threads (which normalize), interns tokens on the calling thread unless intern is false, blocks the loader whenever the budget is exhausted, calls consume for every batch
+    // Assumption :- consume does not keep references into batches it does not copy; memory it retains is not covered by the budget
+    bool run(const FileManager& fm,
+             const std::function<void(std::vector<ProcessedLine>&)>& consume,
+             Stats* stats = nullptr, bool intern = true) const;
+
+    // Objective :- Stream all input files and count token frequencies without materializing the corpus
+    // Input :- fm - file manager describing the inputs, ex - keyword extractor used by the counting stage, counts - frequency vector (indexed by token ID) receiving the totals, stats - optional pointer receiving run statistics
+    // Output :- Returns false if the input path is invalid, true otherwise
+    // Sideeffect :- Runs the pipeline, updates counts
+    // Assumption :- counts may already hold totals to add to
+    bool countTokens(const FileManager& fm, const KeywordExtractor& ex,
+                     std::vector<std::uint32_t>& counts,
+                     Stats* stats = nullptr) const;
+
+    // Objective :- Stream all input files and count token frequencies approximately in the fixed memory of a sketch, leaving the shared vocabulary untouched
+    // Input :- fm - file manager describing the inputs, sketch - sketch receiving the counts, stats - optional pointer receiving run statistics
+    // Output :- Returns false if the input path is invalid, true otherwise
+    // Sideeffect :- Runs the pipeline, interns each batch into a vocabulary dropped after the batch, updates sketch
+    // Assumption :- sketch may already hold counts to add to
+    bool countTokens(const FileManager& fm, KeywordSketch& sketch,
+                     Stats* stats = nullptr) const;
+
+private:
+    Preprocessor& pre;          // Preprocessor used by the worker (normalize) and consumer (intern) stages
+    std::size_t memoryBudget;   // Cap in bytes on the estimated memory of batches in flight
+    std::size_t threads;        // Number of preprocessing workers
+    std::size_t batchBytes;     // Target raw text bytes per batch
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef TEXT_RANKER_H
+#define TEXT_RANKER_H
+
+#include "corpus.h"
+#include "document.h"
+#include <cstddef>
+#include <vector>
+
+// Objective :- Class ranking lines by TextRank centrality: lines that share words with many other well-connected lines rank first, so a line stuffed with keywords but unlike the rest of the material does not
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class TextRanker {
+public:
+    // Objective :- Represents how one ranking went
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct RankStats {
+        std::size_t lines{};       // Lines with tokens (graph nodes)
+        std::size_t edges{};       // Undirected edges between similar lines
+        std::size_t iterations{};  // Power iterations until the ranks settled
+        double seconds{};          // Wall-clock time spent building the graph and iterating
+    };
+
+    // Objective :- Initialize the ranker with the graph and iteration settings
+    // Input :- neighbors - most similar lines each line links to, damping - probability of following a link instead of jumping to a random line
+    // Output :- None (constructor)
+    // Sideeffect :- Stores settings
+    // Assumption :- None (neighbors is at least 1, damping is clamped to [0, 1))
+    explicit TextRanker(std::size_t neighbors = 16, double damping = 0.85);
+
+    // Objective :- Rank every line with tokens by centrality
+    // Input :- corpus - processed lines to rank, stats - optional pointer receiving graph size, iteration count and elapsed time
+    // Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order, earlier lines first on ties; an average line scores 1
+    // Sideeffect :- Builds and releases the similarity graph (see scoreTop), may fill *stats
+    // Assumption :- corpus may be empty, the arenas outlive the result
+    std::vector<ScoredLine> score(const Corpus& corpus, RankStats* stats = nullptr) const;
+
+    // Objective :- Rank lines by centrality and return only the best 'limit' of them
+    // Input :- corpus - processed lines to rank, limit - number of lines needed (e.g. QuestionGenerator::linesNeeded), stats - optional pointer receiving ranking statistics
+    // Output :- Returns references (corpus-wide line index and score) to the first 'limit' lines of score(corpus)
+    // Sideeffect :- Builds an inverted index of the lines' distinct tokens, links each line to its most similar lines through it (word overlap over log lengths), symmetrizes
+    //               the links into a CSR matrix and runs power iteration on it until the ranks settle; all on 'threads' workers, about 24 bytes per line per neighbor,
+    //               released on return; may fill *stats
+    // Assumption :- Same as score(); results do not depend on the thread count
+    std::vector<ScoredRef> scoreTop(const Corpus& corpus, std::size_t limit, RankStats* stats = nullptr) const;
+
+    // Objective :- Set the number of worker threads used to build the graph and iterate (results do not depend on it)
+    // Input :- count - number of threads (0 means one per hardware thread, 1 ranks on the calling thread)
+    // Output :- None (void function)
+    // Sideeffect :- Updates member variable threads
+    // Assumption :- None
+    void setThreads(std::size_t count);
+
+private:
+    std::size_t neighbors;       // Most similar lines each line links to
+    double damping;              // Probability of following a link
+    std::size_t threads = 1;     // Worker threads (0 = all cores)
+};
+
+#endif
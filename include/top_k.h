@@ -0,0 +1,91 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Objective :- Class keeping the best K of a stream of entries in a bounded heap, so selecting K out of N entries costs O(N log K) time and O(K) memory
+// Input :- None (class template declaration); T - entry type, Better - strict weak ordering where better(a, b) means a ranks before b
+// Output :- None (class template declaration)
+// Sideeffect :- None
+template <typename T, typename Better>
+class TopK {
+public:
+    // Objective :- Create an empty selection of at most k entries
+    // Input :- k - number of entries to keep, better - ordering of entries
+    // Output :- None (constructor)
+    // Sideeffect :- Reserves room for k entries
+    // Assumption :- None (k = 0 keeps nothing)
+    TopK(std::size_t k, Better better) : k(k), better(std::move(better)) {
+        heap.reserve(k);
+    }
+
+    // Objective :- Offer one entry to the selection
+    // Input :- entry - candidate entry
+    // Output :- Returns true if the entry is kept (for now), false if it ranks below the K kept entries
+    // Sideeffect :- May replace the worst kept entry
+    // Assumption :- None
+    bool push(const T& entry) {
+        // Not full yet: keep everything
+        if (heap.size() < k) {
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), better);
+            return true;
+        }
+        // Full: replace the worst kept entry (heap front) only by a better one
+        if (k == 0 || !better(entry, heap.front()))
+            return false;
+        std::pop_heap(heap.begin(), heap.end(), better);
+        heap.back() = entry;
+        std::push_heap(heap.begin(), heap.end(), better);
+        return true;
+    }
+
+    // Objective :- Report the number of kept entries
+    // Input :- None
+    // Output :- Returns min(k, entries pushed so far)
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t size() const {
+        return heap.size();
+    }
+
+    // Objective :- Report whether the selection holds k entries, so only entries better than worst() can still enter
+    // Input :- None
+    // Output :- Returns true if size() == k
+    // Sideeffect :- None
+    // Assumption :- None
+    bool full() const {
+        return heap.size() == k;
+    }
+
+    // Objective :- Access the worst kept entry
+    // Input :- None
+    // Output :- Returns reference to the entry that the next better entry would replace
+    // Sideeffect :- None
+    // Assumption :- size() > 0
+    const T& worst() const {
+        return heap.front();
+    }
+
+    // Objective :- Move the kept entries out, best first
+    // Input :- None
+    // Output :- Returns vector of the kept entries sorted by 'better'
+    // Sideeffect :- Leaves the selection empty
+    // Assumption :- None
+    std::vector<T> take() {
+        std::sort_heap(heap.begin(), heap.end(), better);
+        std::vector<T> sorted = std::move(heap);
+        heap.clear();
+        return sorted;
+    }
+
+private:
+    std::size_t k;          // Number of entries to keep
+    Better better;          // Entry ordering
+    std::vector<T> heap;    // Kept entries; heap ordered by 'better', so the worst entry is at the front
+};
+
+#endif
@@ -2,6 +2,8 @@
 #define UI_H
 
 #include "document.h"
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 // Objective :- Namespace containing user interface functions for console interaction
@@ -36,6 +38,34 @@ namespace ui {
     // Sideeffect :- Writes summary information to standard output
     // Assumption :- p is a valid QuestionPaper object with accessible size() methods
     void summarize(const QuestionPaper& p);
+
+    // Objective :- Display how many documents were loaded and the load throughput
+    // Input :- files - number of documents loaded, bytes - total bytes loaded, seconds - time spent loading, unchanged - number of documents reused from the previous run
+    // Output :- None (void function)
+    // Sideeffect :- Writes load statistics to standard output
+    // Assumption :- seconds is non-negative
+    void reportLoad(std::size_t files, std::size_t bytes, double seconds, std::size_t unchanged = 0);
+
+    // Objective :- Display the result of a streaming pass: lines processed, throughput and peak memory in flight
+    // Input :- lines - number of processed lines, bytes - raw bytes streamed, peakBytes - highest memory held by batches in flight, seconds - time of the pass
+    // Output :- None (void function)
+    // Sideeffect :- Writes streaming statistics to standard output
+    // Assumption :- seconds is non-negative
+    void reportStream(std::size_t lines, std::size_t bytes, std::size_t peakBytes, double seconds);
+
+    // Objective :- Display the error bounds of approximate keyword counts
+    // Input :- tokens - occurrences counted (N), counters - Space-Saving counters (k), epsilon - Count-Min error factor, delta - Count-Min failure probability
+    // Output :- None (void function)
+    // Sideeffect :- Writes the bounds to standard output
+    // Assumption :- counters > 0
+    void reportSketch(std::uint64_t tokens, std::size_t counters, double epsilon, double delta);
+
+    // Objective :- Display the result of a TextRank ranking: graph size, iterations and time
+    // Input :- lines - graph nodes (lines with tokens), edges - links between similar lines, iterations - power iterations run, seconds - time of the ranking
+    // Output :- None (void function)
+    // Sideeffect :- Writes ranking statistics to standard output
+    // Assumption :- seconds is non-negative
+    void reportRank(std::size_t lines, std::size_t edges, std::size_t iterations, double seconds);
 }
 
 #endif 
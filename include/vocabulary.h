@@ -0,0 +1,61 @@
+#ifndef VOCABULARY_H
+#define VOCABULARY_H
+
+#include "flat_hash_map.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Dense integer identifier of an interned token
+using TokenId = std::uint32_t;
+
+// Sparse token counts: (token ID, occurrences) for each token that occurs
+using TokenCounts = std::vector<std::pair<TokenId, std::uint32_t>>;
+
+// Objective :- Class interning token strings to dense integer IDs (0, 1, 2, ... in first-seen order) so every later stage counts, scores and matches with integers and strings are only looked up again when rendering
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class Vocabulary {
+public:
+    // Value returned by find() for tokens that were never interned
+    static constexpr TokenId npos = static_cast<TokenId>(-1);
+
+    // Objective :- Return the ID of a token, assigning the next free ID if the token is new
+    // Input :- token - view of the token text
+    // Output :- Returns the token's ID
+    // Sideeffect :- Stores a copy of new tokens
+    // Assumption :- Not called concurrently with any other member function
+    TokenId intern(std::string_view token);
+
+    // Objective :- Look up the ID of a token without adding it
+    // Input :- token - view of the token text
+    // Output :- Returns the token's ID, or npos if it was never interned
+    // Sideeffect :- None
+    // Assumption :- None
+    TokenId find(std::string_view token) const;
+
+    // Objective :- Return the text of an interned token
+    // Input :- id - token ID returned by intern()
+    // Output :- Returns reference to the token text
+    // Sideeffect :- None
+    // Assumption :- id < size(); the reference stays valid for the lifetime of the vocabulary
+    const std::string& text(TokenId id) const;
+
+    // Objective :- Report the number of interned tokens (one past the largest ID)
+    // Input :- None
+    // Output :- Returns the number of interned tokens
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t size() const;
+
+private:
+    std::deque<std::string> strings;                      // Token texts indexed by ID (a deque never moves its elements, so the views below stay valid)
+    FlatHashMap<std::string_view, TokenId, TextHash> ids; // Token text (viewing strings) to ID, in one flat probe array
+};
+
+#endif
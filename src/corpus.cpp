@@ -0,0 +1,183 @@
+#include "../include/corpus.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Objective :- Build a view of a ProcessedLine so owned lines can be used wherever arena lines are expected
+// Input :- line - processed line to view
+// Output :- Returns LineView pointing into line
+// Sideeffect :- None
+// Assumption :- line outlives the view and is not modified while the view is used
+LineView viewOf(const ProcessedLine& line) {
+    LineView view;
+    view.original = line.original;
+    view.cleaned = line.cleaned;
+    view.tokens = TokenSpan{line.tokens.data(), line.tokens.size()};
+    return view;
+}
+
+// Objective :- Create an arena holding copies of the given lines, in order
+// Input :- lines - processed lines to store (released by the caller afterwards)
+// Output :- None (constructor)
+// Sideeffect :- Sizes the arenas once and copies text and token IDs into them
+// Assumption :- None
+DocumentArena::DocumentArena(const std::vector<ProcessedLine>& lines) {
+    // Measure everything first so each arena and column is allocated once
+    std::size_t textBytes = 0, tokenCount = 0;
+    for (const auto& line : lines) {
+        textBytes += line.original.size() + line.cleaned.size();
+        tokenCount += line.tokens.size();
+    }
+    reserve(lines.size(), textBytes, tokenCount);
+    // Copy lines in order
+    for (const auto& line : lines)
+        append(viewOf(line));
+}
+
+// Objective :- Append a copy of one line to the arena
+// Input :- line - view of the line to copy
+// Output :- None (void function)
+// Sideeffect :- Grows the arenas and columns; invalidates views previously returned by line()
+// Assumption :- line does not point into this arena
+void DocumentArena::append(const LineView& line) {
+    // The end marker of the token column starts out as the first entry
+    if (tokenOffset.empty())
+        tokenOffset.push_back(0);
+    // Text columns
+    textOffset.push_back(text.size());
+    originalLength.push_back(static_cast<std::uint32_t>(line.original.size()));
+    cleanedLength.push_back(static_cast<std::uint32_t>(line.cleaned.size()));
+    text.append(line.original.data(), line.original.size());
+    text.append(line.cleaned.data(), line.cleaned.size());
+    // Token column (the new end marker)
+    tokens.insert(tokens.end(), line.tokens.begin(), line.tokens.end());
+    tokenOffset.push_back(static_cast<std::uint32_t>(tokens.size()));
+}
+
+// Objective :- Reserve room for lines, text bytes and tokens so appends do not reallocate
+// Input :- lines - number of lines, textBytes - original plus cleaned bytes, tokenCount - number of token IDs
+// Output :- None (void function)
+// Sideeffect :- Reserves capacity in arenas and columns
+// Assumption :- None
+void DocumentArena::reserve(std::size_t lines, std::size_t textBytes, std::size_t tokenCount) {
+    text.reserve(text.size() + textBytes);
+    tokens.reserve(tokens.size() + tokenCount);
+    textOffset.reserve(textOffset.size() + lines);
+    originalLength.reserve(originalLength.size() + lines);
+    cleanedLength.reserve(cleanedLength.size() + lines);
+    tokenOffset.reserve(tokenOffset.size() + lines + 1);
+}
+
+// Objective :- Replace every stored token ID with its entry in a mapping table (e.g. from a task-local vocabulary to the shared one)
+// Input :- remap - new ID of each old ID
+// Output :- None (void function)
+// Sideeffect :- Rewrites the token column in place
+// Assumption :- Every stored ID is below remap.size()
+void DocumentArena::remapTokens(const std::vector<TokenId>& remap) {
+    for (auto& token : tokens)
+        token = remap[token];
+}
+
+// Objective :- Report the number of lines stored
+// Input :- None
+// Output :- Returns number of lines
+// Sideeffect :- None
+// Assumption :- None
+std::size_t DocumentArena::size() const {
+    return textOffset.size();
+}
+
+// Objective :- View one stored line
+// Input :- i - line index
+// Output :- Returns LineView pointing into the arenas
+// Sideeffect :- None
+// Assumption :- i < size(); the view is valid until the arena is modified or destroyed
+LineView DocumentArena::line(std::size_t i) const {
+    LineView view;
+    const char* start = text.data() + textOffset[i];
+    view.original = std::string_view(start, originalLength[i]);
+    view.cleaned = std::string_view(start + originalLength[i], cleanedLength[i]);
+    view.tokens = TokenSpan{tokens.data() + tokenOffset[i], tokenOffset[i + 1] - tokenOffset[i]};
+    return view;
+}
+
+// Objective :- Access the token column, every line's token IDs back to back (for kernels that walk many lines at once)
+// Input :- None
+// Output :- Returns pointer to the first token ID (line i's tokens start at tokenOffsets()[i])
+// Sideeffect :- None
+// Assumption :- The pointer is valid until the arena is modified or destroyed
+const TokenId* DocumentArena::tokenData() const {
+    return tokens.data();
+}
+
+// Objective :- Access the token offset column
+// Input :- None
+// Output :- Returns pointer to size() + 1 offsets into tokenData(); line i's tokens are [offsets[i], offsets[i + 1]) (nullptr if the arena is empty)
+// Sideeffect :- None
+// Assumption :- The pointer is valid until the arena is modified or destroyed
+const std::uint32_t* DocumentArena::tokenOffsets() const {
+    return tokenOffset.empty() ? nullptr : tokenOffset.data();
+}
+
+// Objective :- Append a document's lines to the end of the corpus
+// Input :- doc - shared arena of the document
+// Output :- None (void function)
+// Sideeffect :- Stores the pointer and updates the line index
+// Assumption :- doc is not null and is not modified while it belongs to the corpus
+void Corpus::add(std::shared_ptr<const DocumentArena> doc) {
+    firstLine.push_back(total);
+    total += doc->size();
+    docs.push_back(std::move(doc));
+}
+
+// Objective :- Remove all documents
+// Input :- None
+// Output :- None (void function)
+// Sideeffect :- Releases the corpus's references to the arenas
+// Assumption :- None
+void Corpus::clear() {
+    docs.clear();
+    firstLine.clear();
+    total = 0;
+}
+
+// Objective :- Report the total number of lines
+// Input :- None
+// Output :- Returns number of lines across all documents
+// Sideeffect :- None
+// Assumption :- None
+std::size_t Corpus::size() const {
+    return total;
+}
+
+// Objective :- Report whether the corpus has no lines
+// Input :- None
+// Output :- Returns true if size() is zero
+// Sideeffect :- None
+// Assumption :- None
+bool Corpus::empty() const {
+    return total == 0;
+}
+
+// Objective :- View the line at a corpus-wide index
+// Input :- i - line index in document order
+// Output :- Returns LineView of the line
+// Sideeffect :- None
+// Assumption :- i < size()
+LineView Corpus::line(std::size_t i) const {
+    // Last document whose first line is at or before i (empty documents are skipped by upper_bound)
+    std::size_t d = std::upper_bound(firstLine.begin(), firstLine.end(), i) - firstLine.begin() - 1;
+    return docs[d]->line(i - firstLine[d]);
+}
+
+// Objective :- Access the documents in order, for sequential walks that stay inside one arena at a time
+// Input :- None
+// Output :- Returns reference to the document arenas
+// Sideeffect :- None
+// Assumption :- None
+const std::vector<std::shared_ptr<const DocumentArena>>& Corpus::documents() const {
+    return docs;
+}
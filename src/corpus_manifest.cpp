@@ -0,0 +1,232 @@
+#include "../include/corpus_manifest.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Objective :- Bind the manifest to a corpus root, discarding all cached state if the root changed
+// Input :- path - cleaned folder or file path being loaded
+// Output :- None (void function)
+// Sideeffect :- Clears entries, totals and merged lines and advances generation() when path differs from the current root
+// Assumption :- None
+void CorpusManifest::setRoot(const std::string& path) {
+    // Same corpus: keep everything
+    if (path == root)
+        return;
+    // Different corpus: start over
+    root = path;
+    entries.clear();
+    totals.clear();
+    docFreq.clear();
+    merged.clear();
+    dirty = true;
+    rootChanges++;
+}
+
+// Objective :- Report how many times the manifest switched to a different root, so the caller can tell when state tied to the previous corpus (e.g. its token IDs) can be dropped
+// Input :- None
+// Output :- Returns the number of root changes so far
+// Sideeffect :- None
+// Assumption :- None
+std::size_t CorpusManifest::generation() const {
+    return rootChanges;
+}
+
+// Objective :- Check whether a file is tracked with exactly the given stamp (and so needs no reading)
+// Input :- name - document name, stamp - current size and modification time of the file
+// Output :- Returns true if the cached entry is up to date
+// Sideeffect :- None
+// Assumption :- None
+bool CorpusManifest::isCurrent(const std::string& name, const FileStamp& stamp) const {
+    // Look up entry by name
+    auto it = entries.find(name);
+    // Current only if tracked with identical size and modification time
+    return it != entries.end() && it->second.stamp.size == stamp.size &&
+           it->second.stamp.mtime == stamp.mtime;
+}
+
+// Objective :- Check whether a tracked file already has the given content hash
+// Input :- name - document name, hash - content hash of the freshly read file
+// Output :- Returns true if the cached entry was built from identical content
+// Sideeffect :- None
+// Assumption :- None
+bool CorpusManifest::hasContent(const std::string& name, std::uint64_t hash) const {
+    // Look up entry by name and compare hashes
+    auto it = entries.find(name);
+    return it != entries.end() && it->second.hash == hash;
+}
+
+// Objective :- Record a new stamp for a file whose content turned out to be unchanged
+// Input :- name - document name, stamp - new size and modification time
+// Output :- None (void function)
+// Sideeffect :- Updates the stamp of the entry
+// Assumption :- name is tracked
+void CorpusManifest::touch(const std::string& name, const FileStamp& stamp) {
+    // Update stamp so the next refresh skips the file without reading it
+    entries[name].stamp = stamp;
+}
+
+// Objective :- Record the stamp and hash of a new or changed file whose results will be supplied through update()
+// Input :- name - document name, stamp - size and modification time, hash - content hash
+// Output :- None (void function)
+// Sideeffect :- Creates the entry if needed and stores stamp and hash
+// Assumption :- update() is called for name before lines() or frequency() are used
+void CorpusManifest::track(const std::string& name, const FileStamp& stamp, std::uint64_t hash) {
+    // Create or fetch entry
+    Entry& entry = entries[name];
+    // Store new stamp and hash
+    entry.stamp = stamp;
+    entry.hash = hash;
+}
+
+// Objective :- Replace the cached results of a document and merge the count delta into the global frequency map
+// Input :- name - document name, lines - processed lines of the document (its arenas, e.g. from Preprocessor::processEach), counts - sparse token counts of the document
+// Output :- None (void function)
+// Sideeffect :- Subtracts old counts, adds new counts and document frequencies, keeps the lines' arenas and the counts, marks merged lines for rebuild
+// Assumption :- name was passed to track() first
+void CorpusManifest::update(const std::string& name, Corpus lines,
+                            TokenCounts counts) {
+    // Fetch entry
+    Entry& entry = entries[name];
+    // Take the old contribution out of the global counts
+    subtract(entry);
+    // Add the new contribution, growing global counts to cover new IDs; every listed token occurs in this document once for its document frequency
+    for (const auto& kv : counts) {
+        if (kv.first >= totals.size()) {
+            totals.resize(static_cast<std::size_t>(kv.first) + 1, 0);
+            docFreq.resize(totals.size(), 0);
+        }
+        totals[kv.first] += kv.second;
+        docFreq[kv.first]++;
+    }
+    // Keep the document's counts for a later subtract
+    entry.counts = std::move(counts);
+    // Keep the new lines' arenas as they are (no text is copied)
+    entry.lines = std::move(lines);
+    // Combined lines must be rebuilt
+    dirty = true;
+}
+
+// Objective :- Forget a document and remove its counts from the global frequency map
+// Input :- name - document name
+// Output :- None (void function)
+// Sideeffect :- Erases the entry and marks merged lines for rebuild
+// Assumption :- None (unknown names are ignored)
+void CorpusManifest::remove(const std::string& name) {
+    // Look up entry
+    auto it = entries.find(name);
+    if (it == entries.end())
+        return;
+    // Remove its counts and the entry itself
+    subtract(it->second);
+    entries.erase(it);
+    // Combined lines must be rebuilt
+    dirty = true;
+}
+
+// Objective :- Forget every document whose name is not in the given list
+// Input :- names - sorted names of the files currently present
+// Output :- None (void function)
+// Sideeffect :- Removes entries of deleted files and their counts
+// Assumption :- names is sorted ascending
+void CorpusManifest::retain(const std::vector<std::string>& names) {
+    // Walk entries and drop those missing from the sorted name list
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (std::binary_search(names.begin(), names.end(), it->first)) {
+            ++it;
+            continue;
+        }
+        // File was deleted: remove its counts and entry
+        subtract(it->second);
+        it = entries.erase(it);
+        dirty = true;
+    }
+}
+
+// Objective :- Report whether any document is tracked
+// Input :- None
+// Output :- Returns true if the manifest has no entries
+// Sideeffect :- None
+// Assumption :- None
+bool CorpusManifest::empty() const {
+    return entries.empty();
+}
+
+// Objective :- Processed lines of all documents in name order, rebuilt only after a change
+// Input :- None
+// Output :- Returns reference to the corpus of all document arenas
+// Sideeffect :- Rebuilds the corpus index if any document changed since the last call (arenas are shared, no text is copied)
+// Assumption :- Reference is invalidated by the next change; arenas stay alive while the corpus refers to them
+const Corpus& CorpusManifest::lines() {
+    // Reuse combined lines when nothing changed
+    if (!dirty)
+        return merged;
+
+    // Rebuild the corpus from the document arenas in name order
+    merged.clear();
+    for (const auto& kv : entries)
+        for (const auto& arena : kv.second.lines.documents())
+            merged.add(arena);
+    // Combined lines are now up to date
+    dirty = false;
+    return merged;
+}
+
+// Objective :- Global token frequencies (indexed by token ID) kept up to date by merging per-document deltas
+// Input :- None
+// Output :- Returns reference to the frequency vector
+// Sideeffect :- None
+// Assumption :- Token IDs come from one Vocabulary for the lifetime of the manifest
+const std::vector<std::uint32_t>& CorpusManifest::frequency() const {
+    return totals;
+}
+
+// Objective :- Document frequencies (indexed by token ID): the number of documents each token occurs in, kept up to date with the same per-document deltas as frequency()
+// Input :- None
+// Output :- Returns reference to the document frequency vector
+// Sideeffect :- None
+// Assumption :- Token IDs come from one Vocabulary for the lifetime of the manifest
+const std::vector<std::uint32_t>& CorpusManifest::documentFrequency() const {
+    return docFreq;
+}
+
+// Objective :- Report the number of documents the frequencies cover
+// Input :- None
+// Output :- Returns number of tracked documents
+// Sideeffect :- None
+// Assumption :- None
+std::size_t CorpusManifest::documentCount() const {
+    return entries.size();
+}
+
+// Objective :- Compute a 64-bit FNV-1a hash of file contents
+// Input :- text - view over the file contents
+// Output :- Returns the hash value
+// Sideeffect :- None
+// Assumption :- None
+std::uint64_t CorpusManifest::hashContent(std::string_view text) {
+    // FNV-1a offset basis
+    std::uint64_t hash = 1469598103934665603ULL;
+    // Mix in each byte
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    // Return hash
+    return hash;
+}
+
+// Objective :- Remove an entry's token counts from the global frequency map
+// Input :- entry - entry whose counts are subtracted
+// Output :- None (void function)
+// Sideeffect :- Decrements totals and document frequencies
+// Assumption :- entry counts were previously added to totals
+void CorpusManifest::subtract(const Entry& entry) {
+    // Decrement each token the document contained
+    for (const auto& kv : entry.counts) {
+        totals[kv.first] -= kv.second;
+        docFreq[kv.first]--;
+    }
+}
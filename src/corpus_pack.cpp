@@ -0,0 +1,254 @@
+#include "../include/corpus_pack.h"
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Format constants
+static const char kMagic[8] = {'Q', 'P', 'G', 'P', 'A', 'C', 'K', '1'};
+static const std::uint32_t kVersion = 1;
+static const std::size_t kHeaderSize = 8 + 4 + 4 + 5 * 8;   // magic, version, count, five u64 fields
+static const std::size_t kDocEntrySize = 8 + 4 + 4 + 8 + 8 + 8;
+static const std::size_t kLineEntrySize = 4 + 4;
+
+// Objective :- Round a size up to the next multiple of 8
+// Input :- n - size in bytes
+// Output :- Returns n rounded up to a multiple of 8
+// Sideeffect :- None
+// Assumption :- None
+static std::uint64_t align8(std::uint64_t n) {
+    return (n + 7) & ~std::uint64_t(7);
+}
+
+// Objective :- Append an unsigned integer to a byte string in little-endian order
+// Input :- out - byte string to append to, value - integer to encode, bytes - width in bytes
+// Output :- None (void function)
+// Sideeffect :- Appends bytes to out
+// Assumption :- bytes is 4 or 8
+static void putLe(std::string& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++)
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+// Objective :- Decode a little-endian unsigned integer from raw bytes
+// Input :- p - pointer to the first byte, bytes - width in bytes
+// Output :- Returns the decoded value
+// Sideeffect :- None
+// Assumption :- p points to at least 'bytes' readable bytes
+static std::uint64_t getLe(const char* p, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+        value = (value << 8) | static_cast<unsigned char>(p[i]);
+    return value;
+}
+
+// Objective :- Check that a range lies inside a section without overflowing
+// Input :- offset - start of the range, length - size of the range, limit - size of the section
+// Output :- Returns true if [offset, offset + length) lies within [0, limit)
+// Sideeffect :- None
+// Assumption :- None
+static bool fits(std::uint64_t offset, std::uint64_t length, std::uint64_t limit) {
+    return offset <= limit && length <= limit - offset;
+}
+
+// Objective :- Write documents to a packed corpus file
+// Input :- docs - documents to pack (their text holds the raw file contents), path - output file path
+// Output :- Returns true on success, false if the file cannot be written or a document exceeds the format limits
+// Sideeffect :- Creates or overwrites the output file, writes error message to cerr on failure
+// Assumption :- Each document's line views point into its text
+bool CorpusPack::write(const std::vector<Document>& docs, const std::string& path) {
+    // Compute section sizes
+    std::uint64_t namesSize = 0, textSize = 0, lineCount = 0;
+    for (const auto& doc : docs) {
+        std::string_view text = doc.text;
+        // Line starts are stored as 32-bit offsets within a document
+        if (text.size() > std::numeric_limits<std::uint32_t>::max()) {
+            std::cerr << "[CorpusPack] Document too large to pack: " << doc.name << "\n";
+            return false;
+        }
+        namesSize += doc.name.size();
+        textSize += text.size();
+        lineCount += doc.lines.size();
+    }
+
+    // Lay out sections one after another
+    std::uint64_t docTable = align8(kHeaderSize);
+    std::uint64_t nameSection = align8(docTable + docs.size() * kDocEntrySize);
+    std::uint64_t textSection = align8(nameSection + namesSize);
+    std::uint64_t lineSection = align8(textSection + textSize);
+    std::uint64_t fileSize = lineSection + lineCount * kLineEntrySize;
+
+    // Header and document table
+    std::string head(kMagic, sizeof(kMagic));
+    putLe(head, kVersion, 4);
+    putLe(head, docs.size(), 4);
+    putLe(head, docTable, 8);
+    putLe(head, nameSection, 8);
+    putLe(head, textSection, 8);
+    putLe(head, lineSection, 8);
+    putLe(head, fileSize, 8);
+    head.resize(docTable, '\0');
+    std::uint64_t nameOffset = 0, textOffset = 0, firstLine = 0;
+    for (const auto& doc : docs) {
+        std::uint64_t textLength = doc.text.size();
+        putLe(head, nameOffset, 8);
+        putLe(head, doc.name.size(), 4);
+        putLe(head, doc.lines.size(), 4);
+        putLe(head, textOffset, 8);
+        putLe(head, textLength, 8);
+        putLe(head, firstLine, 8);
+        nameOffset += doc.name.size();
+        textOffset += textLength;
+        firstLine += doc.lines.size();
+    }
+
+    // Open output file in binary mode
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "[CorpusPack] Cannot write to: " << path << "\n";
+        return false;
+    }
+    // Padding used between sections
+    const char zeros[8] = {};
+
+    // Header and document table
+    out.write(head.data(), head.size());
+    // Names
+    out.write(zeros, nameSection - head.size());
+    for (const auto& doc : docs)
+        out.write(doc.name.data(), doc.name.size());
+    // Raw text of every document
+    out.write(zeros, textSection - (nameSection + namesSize));
+    for (const auto& doc : docs)
+        out.write(doc.text.data(), doc.text.size());
+    // Line index, relative to each document's text
+    out.write(zeros, lineSection - (textSection + textSize));
+    std::string entries;
+    for (const auto& doc : docs) {
+        entries.clear();
+        const char* base = doc.text.data();
+        for (const auto& line : doc.lines) {
+            putLe(entries, static_cast<std::uint64_t>(line.data() - base), 4);
+            putLe(entries, line.size(), 4);
+        }
+        out.write(entries.data(), entries.size());
+    }
+
+    // Report write errors (e.g. disk full)
+    if (!out) {
+        std::cerr << "[CorpusPack] Failed while writing: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Objective :- Decode a packed corpus into Documents whose lines are views into the pack buffer
+// Input :- buffer - contents of a .qpack file (normally memory-mapped), path - file path used in error messages
+// Output :- Returns the packed documents (empty if the pack is malformed)
+// Sideeffect :- Writes error message to cerr if validation fails
+// Assumption :- None (every offset is checked against the buffer size)
+std::vector<Document> CorpusPack::read(const std::shared_ptr<const FileBuffer>& buffer, const std::string& path) {
+    // Collect every document, or none if some entry is malformed
+    std::vector<Document> docs;
+    if (!forEachDocument(buffer, path, [&](Document&& doc) {
+            docs.push_back(std::move(doc));
+            return true;
+        }))
+        docs.clear();
+    // Return packed documents
+    return docs;
+}
+
+// Objective :- Walk the document table of a packed corpus, decoding one document's line index at a time and handing it to a callback, so memory does not grow with the pack
+// Input :- buffer - contents of a .qpack file, path - file path used in error messages, visit - callback receiving each document with lines (returns false to stop early)
+// Output :- Returns false if the pack is malformed (documents before the malformed entry have already been visited), true otherwise
+// Sideeffect :- Calls visit once per document with lines, in pack order; writes error message to cerr if validation fails
+// Assumption :- None (every offset is checked against the buffer size)
+bool CorpusPack::forEachDocument(const std::shared_ptr<const FileBuffer>& buffer, const std::string& path, const std::function<bool(Document&&)>& visit) {
+    // Nothing to walk (the loader already reported the unreadable file)
+    if (!buffer)
+        return true;
+    // Whole pack contents
+    std::string_view pack = buffer->view();
+    const char* base = pack.data();
+    const std::uint64_t size = pack.size();
+    // Report a malformed pack
+    auto invalid = [&]() {
+        std::cerr << "[CorpusPack] Not a valid packed corpus: " << path << "\n";
+        return false;
+    };
+
+    // Header
+    if (size < kHeaderSize || std::memcmp(base, kMagic, sizeof(kMagic)) != 0 || getLe(base + 8, 4) != kVersion)
+        return invalid();
+    std::uint64_t docCount = getLe(base + 12, 4);
+    std::uint64_t docTable = getLe(base + 16, 8);
+    std::uint64_t nameSection = getLe(base + 24, 8);
+    std::uint64_t textSection = getLe(base + 32, 8);
+    std::uint64_t lineSection = getLe(base + 40, 8);
+    std::uint64_t fileSize = getLe(base + 48, 8);
+    // Sections must be ordered and inside the file
+    if (fileSize != size || docTable < kHeaderSize || docTable > size || nameSection < docTable + docCount * kDocEntrySize ||
+        textSection < nameSection || lineSection < textSection || lineSection > size)
+        return invalid();
+    std::uint64_t lineTotal = (size - lineSection) / kLineEntrySize;
+
+    // Documents, decoded only when reached
+    for (std::uint64_t d = 0; d < docCount; d++) {
+        const char* entry = base + docTable + d * kDocEntrySize;
+        std::uint64_t nameOffset = getLe(entry, 8);
+        std::uint64_t nameLength = getLe(entry + 8, 4);
+        std::uint64_t lineCount = getLe(entry + 12, 4);
+        std::uint64_t textOffset = getLe(entry + 16, 8);
+        std::uint64_t textLength = getLe(entry + 24, 8);
+        std::uint64_t firstLine = getLe(entry + 32, 8);
+        // Name, text and line ranges must stay inside their sections
+        if (!fits(nameOffset, nameLength, textSection - nameSection) ||
+            !fits(textOffset, textLength, lineSection - textSection) ||
+            !fits(firstLine, lineCount, lineTotal))
+            return invalid();
+
+        // Build document over the shared pack buffer
+        Document doc;
+        doc.name.assign(base + nameSection + nameOffset, nameLength);
+        doc.buffer = buffer;
+        const char* text = base + textSection + textOffset;
+        doc.text = std::string_view(text, textLength);
+        doc.lines.reserve(lineCount);
+        for (std::uint64_t l = 0; l < lineCount; l++) {
+            const char* line = base + lineSection + (firstLine + l) * kLineEntrySize;
+            std::uint64_t start = getLe(line, 4);
+            std::uint64_t length = getLe(line + 4, 4);
+            if (!fits(start, length, textLength))
+                return invalid();
+            doc.lines.emplace_back(text + start, length);
+        }
+        // Skip documents without lines, like the folder loader does
+        if (!doc.lines.empty() && !visit(std::move(doc)))
+            return true;
+    }
+    // Every document visited
+    return true;
+}
+
+// Objective :- Determine if a filename has the .qpack extension (case-insensitive)
+// Input :- filename - string containing filename to check
+// Output :- Returns true if filename ends with .qpack
+// Sideeffect :- None
+// Assumption :- None
+bool CorpusPack::isPackFile(const std::string& filename) {
+    // Find last occurrence of dot character
+    auto dot = filename.rfind('.');
+    if (dot == std::string::npos)
+        return false;
+    // Compare lowercase extension
+    std::string ext = filename.substr(dot + 1);
+    for (char& c : ext)
+        c = std::tolower(static_cast<unsigned char>(c));
+    return ext == "qpack";
+}
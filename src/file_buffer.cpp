@@ -0,0 +1,155 @@
+#include "../include/file_buffer.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Objective :- Map a file read-only into memory so its bytes are served straight from the page cache
+// Input :- path - string containing path to the file to map
+// Output :- Returns shared pointer to the mapped buffer, or nullptr if the file cannot be opened or mapped
+// Sideeffect :- Opens the file, creates a memory mapping, closes the file descriptor, writes error message to cerr on failure
+// Assumption :- path points to a regular file, filesystem permissions allow reading
+std::shared_ptr<const FileBuffer> FileBuffer::map(const std::string& path) {
+    // Allocate buffer object (constructor is private, so make_shared cannot be used)
+    std::shared_ptr<FileBuffer> buffer(new FileBuffer());
+#ifdef _WIN32
+    // Open file for shared read access
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    // Check if file opened successfully
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[FileBuffer] Failed to open: " << path << '\n';
+        return nullptr;
+    }
+    // Query file size
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    // Empty files cannot be mapped; hand back an empty buffer instead
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return buffer;
+    }
+    // Create read-only mapping object covering the whole file
+    HANDLE section = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // File handle is no longer needed once the mapping object exists
+    CloseHandle(file);
+    if (!section) {
+        std::cerr << "[FileBuffer] Failed to map: " << path << '\n';
+        return nullptr;
+    }
+    // Map a view of the whole file
+    void* base = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+    // View keeps the mapping alive on its own
+    CloseHandle(section);
+    if (!base) {
+        std::cerr << "[FileBuffer] Failed to map: " << path << '\n';
+        return nullptr;
+    }
+    // Store mapping details
+    buffer->mapping = base;
+    buffer->start = static_cast<const char*>(base);
+    buffer->length = static_cast<std::size_t>(size.QuadPart);
+#else
+    // Open file read-only
+    int fd = ::open(path.c_str(), O_RDONLY);
+    // Check if file opened successfully
+    if (fd < 0) {
+        std::cerr << "[FileBuffer] Failed to open: " << path << '\n';
+        return nullptr;
+    }
+    // Query file size
+    struct stat s{};
+    if (fstat(fd, &s) != 0) {
+        ::close(fd);
+        std::cerr << "[FileBuffer] Failed to stat: " << path << '\n';
+        return nullptr;
+    }
+    // Empty files cannot be mapped; hand back an empty buffer instead
+    if (s.st_size == 0) {
+        ::close(fd);
+        return buffer;
+    }
+    // Map the whole file read-only
+    void* base = mmap(nullptr, static_cast<std::size_t>(s.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // Mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "[FileBuffer] Failed to map: " << path << '\n';
+        return nullptr;
+    }
+    // Lines are scanned front to back exactly once
+    madvise(base, static_cast<std::size_t>(s.st_size), MADV_SEQUENTIAL);
+    // Store mapping details
+    buffer->mapping = base;
+    buffer->start = static_cast<const char*>(base);
+    buffer->length = static_cast<std::size_t>(s.st_size);
+#endif
+    // Return mapped buffer
+    return buffer;
+}
+
+// Objective :- Read a whole file into a single heap buffer through an input stream
+// Input :- path - string containing path to the file to read
+// Output :- Returns shared pointer to the loaded buffer, or nullptr if the file cannot be opened
+// Sideeffect :- Opens file stream, reads file content, writes error message to cerr on failure
+// Assumption :- path points to a readable file
+std::shared_ptr<const FileBuffer> FileBuffer::read(const std::string& path) {
+    // Open input file stream in binary mode so line endings are preserved for the line indexer
+    std::ifstream input(path, std::ios::binary);
+    // Check if file opened successfully
+    if (!input.is_open()) {
+        // Write error message to standard error
+        std::cerr << "[FileBuffer] Failed to open: " << path << '\n';
+        // Return null buffer
+        return nullptr;
+    }
+    // Read entire file into one string
+    std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    // Wrap the string as a buffer
+    return fromString(std::move(text));
+}
+
+// Objective :- Wrap an in-memory string as a buffer (takes ownership of the string)
+// Input :- text - string whose contents become the buffer
+// Output :- Returns shared pointer to the buffer
+// Sideeffect :- Moves text into the buffer
+// Assumption :- None
+std::shared_ptr<const FileBuffer> FileBuffer::fromString(std::string text) {
+    // Allocate buffer object
+    std::shared_ptr<FileBuffer> buffer(new FileBuffer());
+    // Take ownership of the text
+    buffer->owned = std::move(text);
+    // Point the view at the owned storage
+    buffer->start = buffer->owned.data();
+    buffer->length = buffer->owned.size();
+    // Return heap-backed buffer
+    return buffer;
+}
+
+// Objective :- Release the memory mapping (if any) held by this buffer
+// Input :- None
+// Output :- None (destructor)
+// Sideeffect :- Unmaps the file region
+// Assumption :- None
+FileBuffer::~FileBuffer() {
+    // Heap buffers release their storage automatically
+    if (!mapping)
+        return;
+#ifdef _WIN32
+    // Unmap the file view
+    UnmapViewOfFile(mapping);
+#else
+    // Unmap the file region
+    munmap(mapping, length);
+#endif
+}
@@ -1,10 +1,14 @@
 #include "../include/file_manager.h"
+#include "../include/corpus_pack.h"
+#include "../include/parallel.h"
 #include <cctype>
+#include <chrono>
+#include <cstring>
 #include <dirent.h>
 #include <sys/stat.h>
-#include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 
@@ -26,154 +30,431 @@ static std::string trim(const std::string& str) {
     return str.substr(first, (last - first + 1));
 }
 
+// Objective :- Split a text buffer into lines like std::getline, jumping from newline to newline with memchr (shared by the loading and streaming paths so both split alike)
+// Input :- text - view over the whole file contents, emit - callable receiving each line without the trailing newline (and without a trailing carriage return), returning false to stop
+// Output :- Returns false if emit stopped the split, true otherwise
+// Sideeffect :- Calls emit once per line, in order
+// Assumption :- None
+template <typename Emit>
+static bool splitLines(std::string_view text, Emit&& emit) {
+    // Start of the current line
+    const char* cursor = text.data();
+    // One past the last byte of the buffer
+    const char* end = text.data() + text.size();
+    while (cursor < end) {
+        // Find next newline (or the end of the buffer for an unterminated last line)
+        const char* nl = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* lineEnd = nl ? nl : end;
+        // Drop carriage return of CRLF line endings
+        const char* trimmed = (lineEnd > cursor && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+        // Hand over the line
+        if (!emit(std::string_view(cursor, static_cast<std::size_t>(trimmed - cursor))))
+            return false;
+        // Continue after the newline
+        cursor = nl ? nl + 1 : end;
+    }
+    return true;
+}
+
 // Objective :- Initialize FileManager with a folder or file path for document loading
-// Input :- folderPath - string containing path to folder or .txt file
+// Input :- folderPath - string containing path to folder or .txt file, mode - how file contents are loaded
 // Output :- None (constructor)
-// Sideeffect :- Stores the provided path in member variable folderPath
+// Sideeffect :- Stores the provided path and mode in member variables
 // Assumption :- folderPath is a valid string (may be empty or invalid path)
-FileManager::FileManager(std::string folderPath)
-    : folderPath(std::move(folderPath)) {} // Move the path string to member variable
+FileManager::FileManager(std::string folderPath, LoadMode mode)
+    : folderPath(std::move(folderPath)), // Move the path string to member variable
+      mode(mode) {}                       // Store loading mode
 
-// Objective :- Load all .txt documents from a folder path or load a single .txt file. Handles both file and directory paths.
-// Input :- None (uses member variable folderPath)
-// Output :- Returns vector of Document objects containing loaded text files
-// Sideeffect :- Reads files from filesystem, writes error messages to cerr, may open and close file streams
+// Objective :- Load all .txt documents from a folder path, a single .txt file, or every document of a packed corpus (.qpack). Handles both file and directory paths.
+// Input :- stats - optional pointer receiving file count, byte count and elapsed time of the load
+// Output :- Returns vector of Document objects containing loaded text files (directory entries in name order)
+// Sideeffect :- Reads files from filesystem on worker threads, writes error messages to cerr, may fill *stats
 // Assumption :- folderPath member variable contains a valid path string, filesystem permissions allow reading
-std::vector<Document> FileManager::loadDocuments() const {
-    // Initialize empty vector to store documents
+std::vector<Document> FileManager::loadDocuments(LoadStats* stats) const {
+    // Start timing the load
+    auto started = std::chrono::steady_clock::now();
+
+    // Resolve the path into the list of files to load
+    std::string path;
+    std::vector<std::string> names, paths;
+    bool packed = false;
+    if (!collectInputs(path, names, paths, packed))
+        return {};
+
+    // Decode a packed corpus from one buffer, or read all files on the worker pool
+    auto docs = packed ? CorpusPack::read(openBuffer(path), path) : loadAll(paths, names);
+    // A single file that loads no lines is reported as empty
+    if (docs.empty() && !packed && paths.size() == 1 && paths[0] == path)
+        std::cerr << "[FileManager] File is empty: " << path << "\n";
+
+    // Report what was loaded and how long it took
+    if (stats) {
+        stats->files = docs.size();
+        stats->bytes = 0;
+        for (const auto& doc : docs)
+            stats->bytes += doc.text.size();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+    // Return loaded documents
+    return docs;
+}
+
+// Objective :- Bring a manifest up to date with the folder or file and load only documents that are new or changed
+// Input :- manifest - manifest from the previous run (reset automatically if the path changed), stats - optional pointer receiving load statistics
+// Output :- Returns the new or changed Documents in name order; unchanged files are not read at all
+// Sideeffect :- Calls stat on every file, reads files whose size or mtime changed, updates stamps, tracks changed files, drops deleted or emptied files from the manifest
+// Assumption :- Caller passes every returned document to manifest.update() before using the manifest's lines or frequencies
+std::vector<Document> FileManager::refresh(CorpusManifest& manifest, LoadStats* stats) const {
+    // Start timing the refresh
+    auto started = std::chrono::steady_clock::now();
+
+    // Resolve the path into the list of files present now
+    std::string path;
+    std::vector<std::string> names, paths;
+    bool packed = false;
+    if (!collectInputs(path, names, paths, packed)) {
+        // Nothing usable: make sure no stale corpus is reused
+        manifest.setRoot("");
+        return {};
+    }
+
+    // A packed corpus is decoded up front (one mapping); its documents all carry the pack's stamp
+    std::vector<Document> packDocs;
+    std::vector<FileStamp> stamps;
+    if (packed) {
+        packDocs = CorpusPack::read(openBuffer(path), path);
+        names.clear();
+        for (const auto& doc : packDocs)
+            names.push_back(doc.name);
+        stamps.assign(names.size(), stampOf(path));
+    }
+
+    // Switch corpus if the path changed, then forget deleted files
+    manifest.setRoot(path);
+    std::vector<std::string> present = names;
+    std::sort(present.begin(), present.end());
+    manifest.retain(present);
+
+    // Stat every file on the pool
+    if (!packed) {
+        stamps.resize(paths.size());
+        parallel::forEach(paths.size(), threads, [&](std::size_t i) {
+            stamps[i] = stampOf(paths[i]);
+        });
+    }
+
+    // Select files whose stamp differs from the manifest
+    std::vector<std::size_t> changed;
+    for (std::size_t i = 0; i < names.size(); i++)
+        if (!manifest.isCurrent(names[i], stamps[i]))
+            changed.push_back(i);
+
+    // Read (or take from the pack) and hash the candidates on the pool
+    std::vector<Document> slots(changed.size());
+    std::vector<std::uint64_t> hashes(changed.size());
+    parallel::forEach(changed.size(), threads, [&](std::size_t k) {
+        std::size_t i = changed[k];
+        slots[k] = packed ? std::move(packDocs[i]) : loadFile(paths[i], names[i]);
+        if (slots[k].buffer)
+            hashes[k] = CorpusManifest::hashContent(slots[k].text);
+    });
+
+    // Update the manifest and keep documents whose content really changed
     std::vector<Document> docs;
-    
-    // Clean the path: trim whitespace and remove quotes
+    std::size_t bytes = 0, touched = 0;
+    for (std::size_t k = 0; k < changed.size(); k++) {
+        const std::string& name = names[changed[k]];
+        const FileStamp& stamp = stamps[changed[k]];
+        // Unreadable or empty files do not contribute to the corpus
+        if (slots[k].lines.empty()) {
+            manifest.remove(name);
+            continue;
+        }
+        bytes += slots[k].text.size();
+        // Touched but identical: remember the new stamp only
+        if (manifest.hasContent(name, hashes[k])) {
+            manifest.touch(name, stamp);
+            touched++;
+            continue;
+        }
+        // New or modified: record it and hand the document back for processing
+        manifest.track(name, stamp, hashes[k]);
+        docs.push_back(std::move(slots[k]));
+    }
+
+    // Report what was read and how long it took
+    if (stats) {
+        stats->files = docs.size();
+        stats->bytes = bytes;
+        stats->unchanged = names.size() - changed.size() + touched;
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+    // Return documents that need processing
+    return docs;
+}
+
+// Objective :- Stream the lines of every input file as batches of bounded size, one file buffer open at a time
+// Input :- batchBytes - target number of text bytes per batch, sink - callback receiving each batch (returns false to stop early)
+// Output :- Returns false if the path is invalid, true otherwise
+// Sideeffect :- Maps or reads files one after another (decoding a packed corpus one document at a time), calls sink for every batch, writes error messages to cerr
+// Assumption :- sink may block (e.g. on a full queue); batches keep their file buffer alive on their own
+bool FileManager::streamBatches(std::size_t batchBytes, const std::function<bool(LineBatch&&)>& sink) const {
+    // Resolve the path into the list of files to stream
+    std::string path;
+    std::vector<std::string> names, paths;
+    bool packed = false;
+    if (!collectInputs(path, names, paths, packed))
+        return false;
+
+    // Sequence number of the next batch
+    std::size_t sequence = 0;
+
+    // Packed corpus: walk the document table one document at a time, cutting batches straight from its precomputed line index
+    if (packed) {
+        CorpusPack::forEachDocument(openBuffer(path), path, [&](Document&& doc) {
+            LineBatch batch;
+            for (std::size_t i = 0; i < doc.lines.size(); i++) {
+                // Add line to the batch
+                batch.lines.push_back(doc.lines[i]);
+                batch.bytes += doc.lines[i].size();
+                // Emit the batch once it reaches the target size or the document ends
+                if (batch.bytes >= batchBytes || i + 1 == doc.lines.size()) {
+                    batch.sequence = sequence++;
+                    batch.buffer = doc.buffer;
+                    if (!sink(std::move(batch)))
+                        return false;
+                    batch = LineBatch();
+                }
+            }
+            return true;
+        });
+        return true;
+    }
+    // Stream files one after another
+    for (const auto& filepath : paths) {
+        // Bring the file into memory; skip unreadable files
+        auto buffer = openBuffer(filepath);
+        if (!buffer)
+            continue;
+
+        // Batch under construction
+        LineBatch batch;
+        // Hand the current batch to the sink and start a new one
+        auto flush = [&]() {
+            batch.sequence = sequence++;
+            batch.buffer = buffer;
+            bool more = sink(std::move(batch));
+            batch = LineBatch();
+            return more;
+        };
+
+        // Split the buffer into lines, emitting each batch once it reaches the target size
+        bool more = splitLines(buffer->view(), [&](std::string_view line) {
+            batch.lines.push_back(line);
+            batch.bytes += line.size();
+            return batch.bytes < batchBytes || flush();
+        });
+        if (!more)
+            return true;
+        // Emit the final partial batch of the file
+        if (!batch.lines.empty() && !flush())
+            return true;
+    }
+    // All files streamed
+    return true;
+}
+
+// Objective :- Set the number of worker threads used to read directory entries
+// Input :- count - number of threads (0 means one per hardware thread)
+// Output :- None (void function)
+// Sideeffect :- Updates member variable threads
+// Assumption :- None
+void FileManager::setThreads(std::size_t count) {
+    // Store thread count
+    threads = count;
+}
+
+// Objective :- Clean the configured path by trimming whitespace and removing surrounding quotes
+// Input :- None (uses member variable folderPath)
+// Output :- Returns cleaned path string (may be empty)
+// Sideeffect :- None
+// Assumption :- None
+std::string FileManager::cleanPath() const {
+    // Trim surrounding whitespace
     std::string path = trim(folderPath);
     // Remove surrounding quotes if present
-    if (!path.empty() && path.front() == '"' && path.back() == '"') {
+    if (path.size() >= 2 && path.front() == '"' && path.back() == '"') {
         // Extract substring without quotes
         path = path.substr(1, path.length() - 2);
         // Trim again after removing quotes
         path = trim(path);
     }
-    
+    // Return cleaned path
+    return path;
+}
+
+// Objective :- List the .txt regular files of a directory in a single readdir pass, sorted by name
+// Input :- dirPath - string containing path to an existing directory
+// Output :- Returns sorted vector of matching file names (not full paths)
+// Sideeffect :- Opens and closes directory stream, calls stat only for entries whose type readdir cannot report
+// Assumption :- dirPath names a readable directory
+std::vector<std::string> FileManager::listTextFiles(const std::string& dirPath) {
+    // Initialize vector to store matching names
+    std::vector<std::string> names;
+    // Open directory stream
+    DIR* dir = opendir(dirPath.c_str());
+    // Check if directory opened successfully
+    if (!dir) {
+        std::cerr << "[FileManager] Cannot open directory: " << dirPath << "\n";
+        return names;
+    }
+
+    struct dirent* entry;
+    // Iterate through directory entries
+    while ((entry = readdir(dir)) != nullptr) {
+        // Get entry name
+        std::string name = entry->d_name;
+        // Filter by extension first; this also skips "." and ".." without a syscall
+        if (!isTextFile(name))
+            continue;
+#ifdef _DIRENT_HAVE_D_TYPE
+        // Trust the entry type when the filesystem reports one
+        if (entry->d_type == DT_REG) {
+            names.push_back(std::move(name));
+            continue;
+        }
+        // Anything other than unknown types and symlinks cannot be a regular file
+        if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK)
+            continue;
+#endif
+        // Fall back to stat (follows symlinks) when the type is not known
+        if (isRegularFile(joinPath(dirPath, name)))
+            names.push_back(std::move(name));
+    }
+    // Close directory stream
+    closedir(dir);
+
+    // Sort names so the document order does not depend on directory layout
+    std::sort(names.begin(), names.end());
+    // Return matching names
+    return names;
+}
+
+// Objective :- Resolve the configured path into the list of .txt files it denotes
+// Input :- path - receives the cleaned path, names - receives document names, paths - receives full file paths (parallel to names), packed - set to true if path is a packed corpus file
+// Output :- Returns true if the path exists and is a directory, a .txt file or a .qpack file, false otherwise
+// Sideeffect :- Calls stat on the path, enumerates directories, writes error messages to cerr
+// Assumption :- None
+bool FileManager::collectInputs(std::string& path, std::vector<std::string>& names,
+                                std::vector<std::string>& paths, bool& packed) const {
+    // Clean the path: trim whitespace and remove quotes
+    path = cleanPath();
     // Check if path is empty after cleaning
     if (path.empty()) {
         // Write error message to standard error
         std::cerr << "[FileManager] Empty path provided.\n";
-        // Return empty vector
-        return docs;
-    }
-    
-    // First, try to open as a file directly
-    std::ifstream fileTest(path);
-    // Check if file opened successfully
-    if (fileTest.is_open()) {
-        // Close the test file stream
-        fileTest.close();
-        // It's a file we can open
-        // Check if it's a .txt file
-        if (isTextFile(path)) {
-            // Create document object
-            Document doc;
-            // Find last directory separator to extract filename
-            size_t lastSlash = path.find_last_of("/\\");
-            // Extract filename from path
-            doc.name = (lastSlash != std::string::npos) ? path.substr(lastSlash + 1) : path;
-            // Read all lines from the file
-            doc.lines = readFileLines(path);
-            // Check if file had content
-            if (!doc.lines.empty()) {
-                // Add document to vector
-                docs.push_back(std::move(doc));
-                // Return documents
-                return docs;
-            } else {
-                // Write error message for empty file
-                std::cerr << "[FileManager] File is empty: " << path << "\n";
-                // Return empty vector
-                return docs;
-            }
-        } else {
-            // Write error message for non-text file
-            std::cerr << "[FileManager] File is not a .txt file: " << path << "\n";
-            // Return empty vector
-            return docs;
-        }
+        return false;
     }
-    
-    // Try with stat to check if it's a file
+
+    // Probe the path once to decide between file and directory handling
     struct stat s{};
-    // Get file status information
-    if (stat(path.c_str(), &s) == 0) {
-        // Check if it's a regular file
-        if (s.st_mode & S_IFREG) {
-            // It's a regular file
-            // Check if it's a .txt file
-            if (isTextFile(path)) {
-                // Create document object
-                Document doc;
-                // Find last directory separator to extract filename
-                size_t lastSlash = path.find_last_of("/\\");
-                // Extract filename from path
-                doc.name = (lastSlash != std::string::npos) ? path.substr(lastSlash + 1) : path;
-                // Read all lines from the file
-                doc.lines = readFileLines(path);
-                // Check if file had content
-                if (!doc.lines.empty()) {
-                    // Add document to vector
-                    docs.push_back(std::move(doc));
-                    // Return documents
-                    return docs;
-                }
-            }
-        }
+    if (stat(path.c_str(), &s) != 0) {
+        // Write error messages to standard error
+        std::cerr << "[FileManager] Path not found: " << path << "\n";
+        std::cerr << "[FileManager] Please check the path and try again.\n";
+        return false;
     }
-    
-    // Try as a directory
-    DIR* dir = opendir(path.c_str());
-    // Check if directory opened successfully
-    if (dir) {
-        struct dirent* entry;
-        // Iterate through directory entries
-        while ((entry = readdir(dir)) != nullptr) {
-            // Get entry name
-            std::string name = entry->d_name;
-            // Skip current and parent directory entries
-            if (name == "." || name == "..")
-                continue;
-
-            // Build full path to file
-            std::string fullPath = path;
-            // Add directory separator if not present
-            if (path.back() != '/' && path.back() != '\\')
-                fullPath += "/";
-            // Append filename to path
-            fullPath += name;
-            
-            // Check if entry is a regular file and has .txt extension
-            if (isRegularFile(fullPath) && isTextFile(name)) {
-                // Create document object
-                Document doc;
-                // Set document name to filename
-                doc.name = name;
-                // Read all lines from the file
-                doc.lines = readFileLines(fullPath);
-                // Add document if it has content
-                if (!doc.lines.empty())
-                    docs.push_back(std::move(doc));
-            }
-        }
-        // Close directory stream
-        closedir(dir);
-        // Return loaded documents
-        return docs;
-    }
-    
-    // If we get here, path doesn't exist
-    // Write error messages to standard error
-    std::cerr << "[FileManager] Path not found: " << path << "\n";
-    std::cerr << "[FileManager] Please check the path and try again.\n";
-    // Return empty vector
+
+    if (S_ISDIR(s.st_mode)) {
+        // Enumerate matching directory entries once
+        names = listTextFiles(path);
+        for (const auto& name : names)
+            paths.push_back(joinPath(path, name));
+        return true;
+    }
+
+    // Single file: must be a .txt file or a packed corpus
+    packed = CorpusPack::isPackFile(path);
+    if (!packed && !isTextFile(path)) {
+        // Write error message for unsupported file
+        std::cerr << "[FileManager] File is not a .txt or .qpack file: " << path << "\n";
+        return false;
+    }
+    // Find last directory separator to extract filename
+    size_t lastSlash = path.find_last_of("/\\");
+    // Document is named after the file
+    names.push_back((lastSlash != std::string::npos) ? path.substr(lastSlash + 1) : path);
+    paths.push_back(path);
+    return true;
+}
+
+// Objective :- Load files on the worker pool and keep the non-empty ones in input order
+// Input :- paths - full paths of the files, names - document names (parallel to paths)
+// Output :- Returns vector of non-empty Documents ordered like paths
+// Sideeffect :- Maps or reads files on worker threads, writes error messages to cerr for unreadable files
+// Assumption :- paths and names have equal length
+std::vector<Document> FileManager::loadAll(const std::vector<std::string>& paths,
+                                           const std::vector<std::string>& names) const {
+    // One slot per file so workers never contend on the output
+    std::vector<Document> slots(paths.size());
+    // Load every file on the pool
+    parallel::forEach(paths.size(), threads, [&](std::size_t i) {
+        slots[i] = loadFile(paths[i], names[i]);
+    });
+
+    // Keep documents with content, preserving order
+    std::vector<Document> docs;
+    docs.reserve(slots.size());
+    for (auto& doc : slots)
+        if (!doc.lines.empty())
+            docs.push_back(std::move(doc));
+    // Return loaded documents
     return docs;
 }
 
+// Objective :- Read the size and modification time of a file
+// Input :- path - string containing path to the file
+// Output :- Returns FileStamp of the file (all zero if stat fails)
+// Sideeffect :- Calls stat system call
+// Assumption :- None
+FileStamp FileManager::stampOf(const std::string& path) {
+    // Structure to hold file status information
+    struct stat s{};
+    FileStamp stamp;
+    // Leave stamp zeroed if the file vanished
+    if (stat(path.c_str(), &s) != 0)
+        return stamp;
+    // Record size
+    stamp.size = static_cast<long long>(s.st_size);
+    // Record modification time with the best precision the platform offers
+#if defined(__linux__)
+    stamp.mtime = static_cast<long long>(s.st_mtim.tv_sec) * 1000000000LL + s.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    stamp.mtime = static_cast<long long>(s.st_mtimespec.tv_sec) * 1000000000LL + s.st_mtimespec.tv_nsec;
+#else
+    stamp.mtime = static_cast<long long>(s.st_mtime) * 1000000000LL;
+#endif
+    // Return stamp
+    return stamp;
+}
+
+// Objective :- Join a directory path and an entry name with a separator when needed
+// Input :- dirPath - directory path, name - entry name
+// Output :- Returns combined path string
+// Sideeffect :- None
+// Assumption :- dirPath is non-empty
+std::string FileManager::joinPath(const std::string& dirPath, const std::string& name) {
+    // Build full path to file
+    std::string fullPath = dirPath;
+    // Add directory separator if not present
+    if (dirPath.back() != '/' && dirPath.back() != '\\')
+        fullPath += "/";
+    // Append filename to path
+    fullPath += name;
+    // Return full path
+    return fullPath;
+}
+
 // Objective :- Check if the given path points to a regular file (not a directory or special file)
 // Input :- path - string containing file system path to check
 // Output :- Returns true if path is a regular file, false otherwise
@@ -185,7 +466,7 @@ bool FileManager::isRegularFile(const std::string& path) {
     // Get file status - returns 0 on success
     if (stat(path.c_str(), &s) == 0)
         // Check if file mode indicates regular file
-        return (s.st_mode & S_IFREG);
+        return S_ISREG(s.st_mode);
     // Return false if stat failed or not a regular file
     return false;
 }
@@ -211,32 +492,55 @@ bool FileManager::isTextFile(const std::string& filename) {
     return ext == "txt";
 }
 
-// Objective :- Read all lines from a text file and return them as a vector of strings
-// Input :- filepath - string containing path to the file to read
-// Output :- Returns vector of strings, each string representing one line from the file
-// Sideeffect :- Opens file stream, reads file content, writes error message to cerr if file cannot be opened
+// Objective :- Bring a file's contents into memory according to the loading mode
+// Input :- filepath - string containing path to the file
+// Output :- Returns shared pointer to the file buffer, or nullptr if the file cannot be read
+// Sideeffect :- Maps or reads the file (falls back to reading if mapping fails), writes error message to cerr on failure
+// Assumption :- filepath points to a regular file
+std::shared_ptr<const FileBuffer> FileManager::openBuffer(const std::string& filepath) const {
+    // Read through a stream in buffered mode
+    if (mode == LoadMode::Buffered)
+        return FileBuffer::read(filepath);
+    // Map the file, falling back to a stream read if mapping failed (e.g. special filesystems)
+    auto buffer = FileBuffer::map(filepath);
+    return buffer ? buffer : FileBuffer::read(filepath);
+}
+
+// Objective :- Load a text file into a Document whose lines are views over the file buffer
+// Input :- filepath - string containing path to the file to read, name - document name to store
+// Output :- Returns Document with buffer and line views (no lines if the file cannot be read)
+// Sideeffect :- Maps or reads the file depending on mode, writes error message to cerr if file cannot be opened
 // Assumption :- filepath points to a valid readable file, file permissions allow reading
-std::vector<std::string> FileManager::readFileLines(const std::string& filepath) {
-    // Open input file stream
-    std::ifstream input(filepath);
-    // Initialize vector to store lines
-    std::vector<std::string> lines;
-    
-    // Check if file opened successfully
-    if (!input.is_open()) {
-        // Write error message to standard error
-        std::cerr << "[FileManager] Failed to open: " << filepath << '\n';
-        // Return empty vector
-        return lines;
+Document FileManager::loadFile(const std::string& filepath, const std::string& name) const {
+    // Create document object
+    Document doc;
+    // Set document name
+    doc.name = name;
+    // Bring the file contents into memory
+    doc.buffer = openBuffer(filepath);
+    // Build the line index over the buffer
+    if (doc.buffer) {
+        doc.text = doc.buffer->view();
+        doc.lines = indexLines(doc.text);
     }
+    // Return loaded document
+    return doc;
+}
 
-    // Variable to hold each line read from file
-    std::string line;
-    // Read file line by line until end of file
-    while (std::getline(input, line))
-        // Add line to vector
+// Objective :- Build the line index of a text buffer in one pass, splitting on newlines like std::getline
+// Input :- text - view over the whole file contents
+// Output :- Returns views of each line without the trailing newline (and without a trailing carriage return)
+// Sideeffect :- None
+// Assumption :- text stays alive while the returned views are used
+std::vector<std::string_view> FileManager::indexLines(std::string_view text) {
+    // Initialize vector to store line views
+    std::vector<std::string_view> lines;
+    // Record a view of every line
+    splitLines(text, [&](std::string_view line) {
         lines.push_back(line);
-    
-    // Return vector containing all lines
+        return true;
+    });
+
+    // Return line index
     return lines;
 }
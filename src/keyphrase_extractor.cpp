@@ -0,0 +1,206 @@
+#include "../include/keyphrase_extractor.h"
+#include "../include/top_k.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Deepest sort done with one radix pass per symbol; deeper sorts use prefix doubling, which needs fewer passes
+static constexpr std::size_t kRadixDepth = 16;
+
+// Objective :- Represents one repeated phrase found in the suffix array before it is rendered as text
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct PhraseCandidate {
+    std::uint32_t start;   // Position of one occurrence in the token stream
+    std::uint32_t length;  // Number of words
+    std::uint32_t count;   // Number of occurrences
+};
+
+// Objective :- Initialize the extractor with the phrase length limit and the minimum number of occurrences
+// Input :- maxLength - longest phrase in words (2 to 255), minCount - fewest occurrences a phrase needs (at least 2)
+// Output :- None (constructor)
+// Sideeffect :- Stores settings
+// Assumption :- None (out-of-range values are clamped)
+KeyphraseExtractor::KeyphraseExtractor(std::size_t maxLength, std::size_t minCount)
+    : maxLength(std::min<std::size_t>(std::max<std::size_t>(maxLength, 2), 255)),  // At least two words; LCP values are stored in one byte
+      minCount(std::max<std::size_t>(minCount, 2)) {}  // A phrase must repeat
+
+// Objective :- Build a suffix array of a symbol sequence, sorting suffixes by at most their first 'depth' symbols: one radix pass per symbol for shallow depths, prefix doubling with radix sort otherwise
+// Input :- text - symbol sequence, alphabet - one past the largest symbol, depth - number of leading symbols that must be fully ordered (0 = whole suffixes)
+// Output :- Returns the start positions of the suffixes in sorted order (suffixes equal in their first 'depth' symbols appear in an unspecified order)
+// Sideeffect :- None
+// Assumption :- Every symbol is below alphabet; text.size() fits in 32 bits
+std::vector<std::uint32_t> KeyphraseExtractor::suffixArray(const std::vector<std::uint32_t>& text,
+                                                           std::size_t alphabet, std::size_t depth) {
+    const std::size_t n = text.size();
+    std::vector<std::uint32_t> sa(n);
+    if (n == 0)
+        return sa;
+
+    // Shallow sorts: radix-sort the first 'depth' symbols directly, last one first (one stable counting sort per symbol)
+    if (depth != 0 && depth <= kRadixDepth) {
+        std::vector<std::uint32_t> sorted(n), count(alphabet + 2);
+        for (std::size_t i = 0; i < n; i++)
+            sa[i] = static_cast<std::uint32_t>(i);
+        for (std::size_t d = depth; d-- > 0;) {
+            // Symbol d of a suffix, shifted by one so a suffix that has already ended sorts lowest
+            auto symbol = [&](std::size_t i) -> std::size_t { return i + d < n ? text[i + d] + 1 : 0; };
+            std::fill(count.begin(), count.end(), 0);
+            for (std::size_t i = 0; i < n; i++)
+                count[symbol(i) + 1]++;
+            for (std::size_t c = 1; c < count.size(); c++)
+                count[c] += count[c - 1];
+            for (std::size_t j = 0; j < n; j++)
+                sorted[count[symbol(sa[j])]++] = sa[j];
+            sa.swap(sorted);
+        }
+        return sa;
+    }
+
+    // Deep sorts: prefix doubling, starting with a counting sort by the first symbol
+    std::vector<std::uint32_t> count(std::max(alphabet, n) + 1, 0);
+    for (std::uint32_t s : text)
+        count[s + 1]++;
+    for (std::size_t s = 1; s <= alphabet; s++)
+        count[s] += count[s - 1];
+    for (std::size_t i = 0; i < n; i++)
+        sa[count[text[i]]++] = static_cast<std::uint32_t>(i);
+
+    // Dense rank of each suffix by its first symbol
+    std::vector<std::uint32_t> rank(n), next(n);
+    std::size_t classes = 1;
+    rank[sa[0]] = 0;
+    for (std::size_t j = 1; j < n; j++) {
+        if (text[sa[j]] != text[sa[j - 1]])
+            classes++;
+        rank[sa[j]] = static_cast<std::uint32_t>(classes - 1);
+    }
+
+    // Each round orders suffixes by twice as many symbols; stop once every rank is distinct or deep enough
+    for (std::size_t k = 1; classes < n && (depth == 0 || k < depth); k *= 2) {
+        // Order by the second half: suffixes without one come first, then the others in current order
+        std::size_t p = 0;
+        for (std::size_t i = (n > k ? n - k : 0); i < n; i++)
+            next[p++] = static_cast<std::uint32_t>(i);
+        for (std::size_t j = 0; j < n; j++)
+            if (sa[j] >= k)
+                next[p++] = static_cast<std::uint32_t>(sa[j] - k);
+
+        // Stable counting sort by the first half
+        std::fill(count.begin(), count.begin() + classes + 1, 0);
+        for (std::size_t i = 0; i < n; i++)
+            count[rank[i] + 1]++;
+        for (std::size_t c = 1; c <= classes; c++)
+            count[c] += count[c - 1];
+        for (std::size_t j = 0; j < n; j++)
+            sa[count[rank[next[j]]]++] = next[j];
+
+        // New ranks from (first half, second half) pairs; a missing second half sorts lowest
+        auto second = [&](std::uint32_t i) { return i + k < n ? static_cast<std::int64_t>(rank[i + k]) : -1; };
+        next[sa[0]] = 0;
+        classes = 1;
+        for (std::size_t j = 1; j < n; j++) {
+            if (rank[sa[j]] != rank[sa[j - 1]] || second(sa[j]) != second(sa[j - 1]))
+                classes++;
+            next[sa[j]] = static_cast<std::uint32_t>(classes - 1);
+        }
+        rank.swap(next);
+    }
+    return sa;
+}
+
+// Objective :- Find the most frequent repeated phrases of 2..maxLength words, never crossing a line boundary
+// Input :- corpus - processed lines whose tokens form the token stream, vocab - vocabulary used to render phrases, limit - maximum number of phrases to return
+// Output :- Returns vector of pairs (phrase with words separated by single spaces, occurrence count) sorted by count descending, then word by word for ties
+// Sideeffect :- Builds the token stream, suffix array and LCP array (about 13 bytes per token, released on return)
+// Assumption :- All token IDs in corpus are in vocab. Only maximal phrases are reported: a phrase is dropped when every occurrence extends by the same word on the right or on the left.
+std::vector<std::pair<std::string, std::size_t>> KeyphraseExtractor::topPhrases(const Corpus& corpus,
+                                                                                const Vocabulary& vocab,
+                                                                                std::size_t limit) const {
+    std::vector<std::pair<std::string, std::size_t>> phrases;
+    if (limit == 0)
+        return phrases;
+
+    // Token stream: every line's token IDs followed by a separator symbol that is not a token ID
+    const std::uint32_t separator = static_cast<std::uint32_t>(vocab.size());
+    std::vector<std::uint32_t> stream;
+    for (const auto& doc : corpus.documents())
+        for (std::size_t i = 0; i < doc->size(); i++) {
+            TokenSpan tokens = doc->line(i).tokens;
+            // Lines too short to hold a phrase cannot contribute
+            if (tokens.size() < 2)
+                continue;
+            stream.insert(stream.end(), tokens.begin(), tokens.end());
+            stream.push_back(separator);
+        }
+    const std::size_t n = stream.size();
+    if (n == 0)
+        return phrases;
+
+    // Suffixes only need ordering by their first maxLength words to group equal phrases
+    std::vector<std::uint32_t> sa = suffixArray(stream, separator + 1, maxLength);
+
+    // LCP with the previous suffix, capped at maxLength; a separator never matches, so no phrase crosses a line end
+    std::vector<std::uint8_t> lcp(n, 0);
+    for (std::size_t j = 1; j < n; j++) {
+        std::size_t a = sa[j - 1], b = sa[j], l = 0;
+        while (l < maxLength && stream[a + l] == stream[b + l] && stream[a + l] != separator)
+            l++;
+        lcp[j] = static_cast<std::uint8_t>(l);
+    }
+
+    // Rank by count, then word by word so ties are deterministic
+    auto better = [&](const PhraseCandidate& a, const PhraseCandidate& b) {
+        if (a.count != b.count)
+            return a.count > b.count;
+        for (std::uint32_t w = 0; w < a.length && w < b.length; w++)
+            if (stream[a.start + w] != stream[b.start + w])
+                return vocab.text(stream[a.start + w]) < vocab.text(stream[b.start + w]);
+        return a.length < b.length;
+    };
+    TopK<PhraseCandidate, decltype(better)> top(limit, better);
+
+    // Every run of suffixes sharing at least len words is one phrase of that length
+    for (std::size_t len = 2; len <= maxLength; len++) {
+        std::size_t first = 0;
+        while (first < n) {
+            std::size_t end = first + 1;
+            bool extendsRight = true;
+            while (end < n && lcp[end] >= len) {
+                // The run only extends right if all its suffixes share one more word
+                if (lcp[end] == len)
+                    extendsRight = false;
+                end++;
+            }
+            std::size_t count = end - first;
+            // Skip rare phrases and, once the selection is full, phrases that cannot beat its worst entry
+            bool contender = count >= minCount && (!top.full() || count >= top.worst().count);
+            if (contender && (len == maxLength || !extendsRight)) {
+                // Left-maximal unless every occurrence follows the same word
+                bool extendsLeft = sa[first] > 0 && stream[sa[first] - 1] != separator;
+                for (std::size_t j = first + 1; j < end && extendsLeft; j++)
+                    extendsLeft = sa[j] > 0 && stream[sa[j] - 1] == stream[sa[first] - 1];
+                if (!extendsLeft)
+                    top.push({sa[first], static_cast<std::uint32_t>(len), static_cast<std::uint32_t>(count)});
+            }
+            first = end;
+        }
+    }
+    std::vector<PhraseCandidate> best = top.take();
+
+    // Render the best phrases as text
+    for (const auto& phrase : best) {
+        std::string text;
+        for (std::uint32_t w = 0; w < phrase.length; w++) {
+            if (w > 0)
+                text += ' ';
+            text += vocab.text(stream[phrase.start + w]);
+        }
+        phrases.emplace_back(std::move(text), phrase.count);
+    }
+    return phrases;
+}
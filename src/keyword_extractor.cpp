@@ -1,52 +1,225 @@
 #include "../include/keyword_extractor.h"
+#include "../include/parallel.h"
 #include <algorithm>
-#include <string>
-#include <unordered_map>
+#include <cmath>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
-// Objective :- Count the frequency of each token in the input vector and return a frequency map
-// Input :- tokens - vector of strings containing tokens to count
-// Output :- Returns unordered_map with token as key and frequency count as value
+// Objective :- Per-worker dense counting table that remembers which IDs it touched, so it can be emptied into a sparse list without scanning every ID
+// Input :- None (data structure)
+// Output :- None (data structure)
 // Sideeffect :- None
-// Assumption :- tokens vector may be empty, all tokens are valid strings
-std::unordered_map<std::string, std::size_t> KeywordExtractor::frequency(const std::vector<std::string>& tokens) const {
-    // Initialize empty map to store token frequencies
-    std::unordered_map<std::string, std::size_t> counts;
-    // Iterate through each token in the vector
-    for (const auto& token : tokens) {
-        // Increment count for current token (creates entry if doesn't exist)
-        ++counts[token];
+struct CountTable {
+    std::vector<std::uint32_t> counts;   // Count per token ID (all zero between uses)
+    std::vector<TokenId> touched;        // IDs with a non-zero count, in order of first occurrence
+
+    // Objective :- Add occurrences of one token
+    // Input :- id - token ID, n - number of occurrences
+    // Output :- None (void function)
+    // Sideeffect :- Grows the table to cover id, records id on its first occurrence
+    // Assumption :- n > 0
+    void add(TokenId id, std::uint32_t n) {
+        if (id >= counts.size())
+            counts.resize(static_cast<std::size_t>(id) + 1, 0);
+        if (counts[id] == 0)
+            touched.push_back(id);
+        counts[id] += n;
+    }
+
+    // Objective :- Move the counts out as a sparse list and reset the table for the next use
+    // Input :- out - list receiving (token ID, count) pairs in order of first occurrence
+    // Output :- None (void function)
+    // Sideeffect :- Replaces out, zeroes the touched entries
+    // Assumption :- None
+    void drain(TokenCounts& out) {
+        out.clear();
+        out.reserve(touched.size());
+        for (TokenId id : touched) {
+            out.emplace_back(id, counts[id]);
+            counts[id] = 0;
+        }
+        touched.clear();
     }
-    // Return frequency map
-    return counts;
-}
-
-// Objective :- Extract top N keywords from frequency map, sorted by frequency (descending), then alphabetically for ties
-// Input :- freq - unordered_map containing token frequencies, limit - maximum number of keywords to return
-// Output :- Returns vector of pairs (keyword, frequency) sorted by frequency descending, limited to 'limit' entries
-// Sideeffect :- Creates and sorts a vector, may resize the result vector
-// Assumption :- freq map may be empty, limit is a positive integer
-std::vector<std::pair<std::string, std::size_t>> KeywordExtractor::topKeywords(
-    const std::unordered_map<std::string, std::size_t>& freq, std::size_t limit) const {
-    
-    // Convert frequency map to vector of pairs
-    std::vector<std::pair<std::string, std::size_t>> ranked(freq.begin(), freq.end());
-    // Sort vector: first by frequency (descending), then alphabetically by keyword for ties
-    std::sort(ranked.begin(), ranked.end(),
-              [](const auto& a, const auto& b) {
-                  // If frequencies are equal, sort alphabetically by keyword
-                  if (a.second == b.second)
-                      return a.first < b.first;
-                  // Otherwise sort by frequency descending
-                  return a.second > b.second;
-              });
-    
-    // Limit result to specified number of top keywords
-    if (ranked.size() > limit)
-        ranked.resize(limit);
-    
+};
+
+// Objective :- Count the tokens of several documents on several threads, straight from the token columns of their arenas
+// Input :- docs - processed lines of each document (e.g. from Preprocessor::processEach), threads - number of worker threads (0 = all cores)
+// Output :- Returns one sparse count list per document: (token ID, occurrences) in order of first occurrence
+// Sideeffect :- Counts the arenas in parallel into per-thread tables, then merges each document's arenas in parallel
+// Assumption :- docs is not modified during the call
+std::vector<TokenCounts> KeywordExtractor::countEach(const std::vector<Corpus>& docs, std::size_t threads) const {
+    // Objective :- One parallel counting task: one arena of one document and its counts
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct Chunk {
+        const DocumentArena* arena{};   // Lines to count
+        TokenCounts counts;             // Token counts of the arena
+    };
+
+    // One chunk per arena (Preprocessor::processEach makes one per kChunkLines lines); a document's chunks are contiguous starting at firstChunk[d]
+    std::vector<Chunk> chunks;
+    std::vector<std::size_t> firstChunk(docs.size() + 1, 0);
+    for (std::size_t d = 0; d < docs.size(); d++) {
+        firstChunk[d] = chunks.size();
+        for (const auto& arena : docs[d].documents())
+            chunks.push_back(Chunk{arena.get(), {}});
+    }
+    firstChunk[docs.size()] = chunks.size();
+
+    // One table per worker, reused across the tasks it runs (never more workers than tasks)
+    std::vector<CountTable> tables(std::max<std::size_t>(1, std::min(parallel::resolveThreads(threads), std::max(chunks.size(), docs.size()))));
+
+    // Count chunks in parallel
+    parallel::forEachWorker(chunks.size(), threads, [&](std::size_t c, std::size_t w) {
+        CountTable& table = tables[w];
+        const DocumentArena& arena = *chunks[c].arena;
+        // The token column holds every line's tokens back to back
+        const TokenId* tokens = arena.tokenData();
+        std::size_t count = arena.size() > 0 ? arena.tokenOffsets()[arena.size()] : 0;
+        for (std::size_t i = 0; i < count; i++)
+            table.add(tokens[i], 1);
+        table.drain(chunks[c].counts);
+    });
+
+    // Merge each document's chunks, documents in parallel
+    std::vector<TokenCounts> result(docs.size());
+    parallel::forEachWorker(docs.size(), threads, [&](std::size_t d, std::size_t w) {
+        std::size_t first = firstChunk[d], last = firstChunk[d + 1];
+        // A single chunk already holds the document's counts
+        if (last - first == 1) {
+            result[d] = std::move(chunks[first].counts);
+            return;
+        }
+        CountTable& table = tables[w];
+        for (std::size_t c = first; c < last; c++)
+            for (const auto& kv : chunks[c].counts)
+                table.add(kv.first, kv.second);
+        table.drain(result[d]);
+    });
+    // Return per-document counts
+    return result;
+}
+
+// Objective :- Add the token counts of a batch of processed lines to an existing frequency vector
+// Input :- lines - processed lines whose tokens are counted, counts - frequency vector to update
+// Output :- None (void function)
+// Sideeffect :- Grows counts to cover new IDs, increments counts for every token in lines
+// Assumption :- lines may be empty
+void KeywordExtractor::accumulate(const std::vector<ProcessedLine>& lines, std::vector<std::uint32_t>& counts) const {
+    // Count tokens line by line without building a flat token vector
+    for (const auto& line : lines)
+        for (TokenId token : line.tokens) {
+            if (token >= counts.size())
+                counts.resize(token + 1, 0);
+            ++counts[token];
+        }
+}
+
+// Objective :- Extract top N keywords from a frequency vector, sorted by frequency (descending), then alphabetically for ties
+// Input :- freq - frequency of each token ID, vocab - vocabulary used to order ties by text, limit - maximum number of keywords to return
+// Output :- Returns vector of pairs (keyword ID, frequency) sorted by frequency descending, limited to 'limit' entries
+// Sideeffect :- Keeps a bounded heap of 'limit' entries (O(V log limit) time for V token IDs)
+// Assumption :- freq may be empty (zero counts are skipped), every ID with a non-zero count is in vocab, limit is a positive integer
+std::vector<std::pair<TokenId, std::size_t>> KeywordExtractor::topKeywords(
+    const std::vector<std::uint32_t>& freq, const Vocabulary& vocab, std::size_t limit) const {
+    // Offer every token that occurs; only the best 'limit' are kept
+    KeywordTopK top(vocab, limit);
+    for (std::size_t id = 0; id < freq.size(); id++)
+        top.add(static_cast<TokenId>(id), freq[id]);
     // Return sorted and limited keyword list
-    return ranked;
+    return top.take();
 }
 
+// Objective :- Weight every token by TF-IDF: its corpus frequency times log((documents + 1) / document frequency), so words found in every document (boilerplate such as "chapter") weigh little next to words concentrated in a few
+// Input :- freq - frequency of each token ID, docFreq - number of documents containing each token ID, documents - number of documents
+// Output :- Returns weight of each token ID (same size as freq; tokens that do not occur weigh zero)
+// Sideeffect :- Creates weight vector
+// Assumption :- docFreq covers every ID with a non-zero count in freq; with a single document the weights are proportional to freq
+std::vector<float> KeywordExtractor::tfidf(const std::vector<std::uint32_t>& freq,
+                                           const std::vector<std::uint32_t>& docFreq,
+                                           std::size_t documents) const {
+    std::vector<float> weight(freq.size(), 0.0f);
+    for (std::size_t id = 0; id < freq.size(); id++) {
+        // Skip tokens that do not occur
+        if (freq[id] == 0 || docFreq[id] == 0)
+            continue;
+        // IDF, shifted by one document so a token found in every document keeps a small positive weight
+        double idf = std::log((documents + 1.0) / docFreq[id]);
+        weight[id] = static_cast<float>(freq[id] * idf);
+    }
+    // Return weights
+    return weight;
+}
+
+// Objective :- Extract top N keywords by weight (e.g. from tfidf()), then alphabetically for ties
+// Input :- weight - weight of each token ID, freq - frequency of each token ID (reported with the keyword), vocab - vocabulary used to order ties by text, limit - maximum number of keywords to return
+// Output :- Returns vector of pairs (keyword ID, frequency) sorted by weight descending, limited to 'limit' entries
+// Sideeffect :- Keeps a bounded heap of 'limit' entries
+// Assumption :- weight and freq have the same size, zero weights are skipped, every ID with a non-zero weight is in vocab
+std::vector<std::pair<TokenId, std::size_t>> KeywordExtractor::topKeywords(
+    const std::vector<float>& weight, const std::vector<std::uint32_t>& freq,
+    const Vocabulary& vocab, std::size_t limit) const {
+    // Rank by weight, then text
+    auto better = [&](TokenId a, TokenId b) {
+        if (weight[a] == weight[b])
+            return vocab.text(a) < vocab.text(b);
+        return weight[a] > weight[b];
+    };
+    TopK<TokenId, decltype(better)> top(limit, better);
+    for (std::size_t id = 0; id < weight.size(); id++)
+        if (weight[id] > 0.0f)
+            top.push(static_cast<TokenId>(id));
+    // Report each keyword with its frequency
+    std::vector<std::pair<TokenId, std::size_t>> keywords;
+    for (TokenId id : top.take())
+        keywords.emplace_back(id, freq[id]);
+    return keywords;
+}
+
+// Objective :- Create an empty selection of at most 'limit' keywords
+// Input :- vocab - vocabulary used to order ties by text, limit - maximum number of keywords to keep
+// Output :- None (constructor)
+// Sideeffect :- Reserves room for limit entries
+// Assumption :- vocab outlives the selection and holds every ID that is added
+KeywordTopK::KeywordTopK(const Vocabulary& vocab, std::size_t limit)
+    : top(limit, ByRank{&vocab}) {}  // Bounded heap ordered by rank
+
+// Objective :- Offer one keyword with its final count
+// Input :- id - keyword ID, count - number of occurrences
+// Output :- None (void function)
+// Sideeffect :- May replace the lowest-ranked kept keyword; zero counts are ignored
+// Assumption :- Each ID is added at most once
+void KeywordTopK::add(TokenId id, std::size_t count) {
+    // Skip tokens that do not occur
+    if (count == 0)
+        return;
+    // Cheap reject before the comparison that may look at text
+    if (top.full() && top.size() > 0 && count < top.worst().second)
+        return;
+    top.push({id, count});
+}
+
+// Objective :- Move the selected keywords out, best first
+// Input :- None
+// Output :- Returns vector of pairs (keyword ID, frequency) sorted by frequency descending, then alphabetically
+// Sideeffect :- Leaves the selection empty
+// Assumption :- None
+std::vector<std::pair<TokenId, std::size_t>> KeywordTopK::take() {
+    return top.take();
+}
+
+// Objective :- Ranking of (keyword ID, count) entries: higher count first, then alphabetical text
+// Input :- a, b - entries to compare
+// Output :- Returns true if a ranks before b
+// Sideeffect :- None
+// Assumption :- Both IDs are in vocab
+bool KeywordTopK::ByRank::operator()(const std::pair<TokenId, std::size_t>& a,
+                                     const std::pair<TokenId, std::size_t>& b) const {
+    // If frequencies are equal, sort alphabetically by keyword
+    if (a.second == b.second)
+        return vocab->text(a.first) < vocab->text(b.first);
+    // Otherwise sort by frequency descending
+    return a.second > b.second;
+}
@@ -0,0 +1,253 @@
+#include "../include/keyword_sketch.h"
+#include "../include/top_k.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Number of Count-Min rows (delta = e^-4, about 1.8%)
+static const std::size_t kSketchDepth = 4;
+
+// Estimated bytes per Space-Saving counter (counter, index entry and short token text)
+static const std::size_t kCounterBytes = 128;
+
+// Smallest budget the sketch accepts
+static const std::size_t kMinSketchBytes = 64 * 1024;
+
+// Objective :- Hash a token to 64 bits (FNV-1a followed by the murmur3 finalizer so all bits are well mixed)
+// Input :- text - token bytes
+// Output :- Returns the hash value
+// Sideeffect :- None
+// Assumption :- None
+static std::uint64_t hashToken(std::string_view text) {
+    // FNV-1a over the bytes
+    std::uint64_t x = 1469598103934665603ULL;
+    for (char c : text) {
+        x ^= static_cast<unsigned char>(c);
+        x *= 1099511628211ULL;
+    }
+    // Finalize
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Objective :- Add to a 32-bit count, stopping at the 32-bit maximum instead of wrapping
+// Input :- value - current count, count - occurrences to add
+// Output :- Returns min(value + count, 2^32 - 1)
+// Sideeffect :- None
+// Assumption :- None
+static std::uint32_t saturatingAdd(std::uint32_t value, std::uint32_t count) {
+    return static_cast<std::uint32_t>(std::min<std::uint64_t>(static_cast<std::uint64_t>(value) + count, std::numeric_limits<std::uint32_t>::max()));
+}
+
+// Objective :- Create an empty sketch sized to a memory budget (a quarter for Space-Saving counters, the rest for the Count-Min table)
+// Input :- memoryBudget - bytes the sketch may use
+// Output :- None (constructor)
+// Sideeffect :- Allocates the Count-Min table and reserves the counters
+// Assumption :- None (tiny budgets are raised to a small minimum)
+KeywordSketch::KeywordSketch(std::size_t memoryBudget) : depth(kSketchDepth) {
+    std::size_t budget = std::max(memoryBudget, kMinSketchBytes);
+    // Space-Saving counters from a quarter of the budget
+    slots = budget / 4 / kCounterBytes;
+    counters.reserve(slots);
+    index.reserve(slots);
+    // Widest power-of-two Count-Min rows that fit in the rest
+    std::size_t width = 1;
+    while (depth * width * 2 * sizeof(std::uint32_t) <= budget - budget / 4)
+        width *= 2;
+    widthMask = width - 1;
+    table.assign(depth * width, 0);
+}
+
+// Objective :- Count occurrences of one token
+// Input :- token - token text, count - number of occurrences
+// Output :- None (void function)
+// Sideeffect :- Updates the Count-Min table and the Space-Saving counters (may evict the smallest counter)
+// Assumption :- count > 0; distinct tokens have distinct 64-bit hashes
+void KeywordSketch::add(std::string_view token, std::uint32_t count) {
+    tokens += count;
+    std::uint64_t hash = hashToken(token);
+
+    // Count-Min: one counter per row, columns derived from the two halves of the hash (saturating at the 32-bit maximum)
+    std::uint64_t h1 = hash & 0xFFFFFFFFULL, h2 = (hash >> 32) | 1;
+    for (std::size_t row = 0; row < depth; row++) {
+        std::uint32_t& cell = table[row * (widthMask + 1) + ((h1 + row * h2) & widthMask)];
+        cell = saturatingAdd(cell, count);
+    }
+
+    // Space-Saving: bump the token's counter if it has one (saturating like the Count-Min cells, so a heavy hitter past 2^32 stays the largest)
+    if (const std::uint32_t* position = index.find(hash)) {
+        std::size_t at = *position;
+        counters[at].count = saturatingAdd(counters[at].count, count);
+        siftDown(at);
+        return;
+    }
+    if (slots == 0)
+        return;
+    // Free counter available: start a new one
+    if (counters.size() < slots) {
+        counters.push_back(Counter{std::string(token), hash, count, 0});
+        index.insert(hash, static_cast<std::uint32_t>(counters.size() - 1));
+        siftUp(counters.size() - 1);
+        return;
+    }
+    // Otherwise take over the smallest counter, inheriting its count as the error
+    Counter& smallest = counters[0];
+    index.erase(smallest.hash);
+    smallest.token.assign(token.data(), token.size());
+    smallest.hash = hash;
+    smallest.error = smallest.count;
+    smallest.count = saturatingAdd(smallest.count, count);
+    index.insert(hash, 0);
+    siftDown(0);
+}
+
+// Objective :- Count the tokens of a batch of lines whose token IDs refer to a batch-local vocabulary
+// Input :- lines - processed lines, local - vocabulary the line tokens refer to
+// Output :- None (void function)
+// Sideeffect :- Counts each distinct token of the batch once with its batch count
+// Assumption :- Every token ID in lines is in local
+void KeywordSketch::accumulate(const std::vector<ProcessedLine>& lines, const Vocabulary& local) {
+    // Exact counts within the batch (the local vocabulary is small)
+    std::vector<std::uint32_t> counts(local.size(), 0);
+    for (const auto& line : lines)
+        for (TokenId token : line.tokens)
+            counts[token]++;
+    // One sketch update per distinct token
+    for (std::size_t id = 0; id < counts.size(); id++)
+        if (counts[id] > 0)
+            add(local.text(static_cast<TokenId>(id)), counts[id]);
+}
+
+// Objective :- Estimate how often a token occurred (Count-Min point query)
+// Input :- token - token text
+// Output :- Returns an estimate that is never below the true count (see the class comment for the upper bound)
+// Sideeffect :- None
+// Assumption :- None
+std::uint32_t KeywordSketch::estimate(std::string_view token) const {
+    std::uint64_t hash = hashToken(token);
+    std::uint64_t h1 = hash & 0xFFFFFFFFULL, h2 = (hash >> 32) | 1;
+    // Smallest of the token's counters across rows
+    std::uint32_t best = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t row = 0; row < depth; row++)
+        best = std::min(best, table[row * (widthMask + 1) + ((h1 + row * h2) & widthMask)]);
+    return best;
+}
+
+// Objective :- Report the largest Space-Saving count, an upper bound of the most frequent token's count used to normalize scores
+// Input :- None
+// Output :- Returns the largest counter value (0 if nothing was counted)
+// Sideeffect :- None
+// Assumption :- None
+std::uint32_t KeywordSketch::maxCount() const {
+    std::uint32_t best = 0;
+    for (const auto& counter : counters)
+        best = std::max(best, counter.count);
+    return best;
+}
+
+// Objective :- Extract the top keywords from the Space-Saving counters, sorted by count (descending), then alphabetically for ties
+// Input :- vocab - vocabulary the selected keywords are interned into, limit - maximum number of keywords to return
+// Output :- Returns vector of pairs (keyword ID, estimated count), limited to 'limit' entries
+// Sideeffect :- Interns only the selected keywords into vocab
+// Assumption :- None
+std::vector<std::pair<TokenId, std::size_t>> KeywordSketch::topKeywords(Vocabulary& vocab, std::size_t limit) const {
+    // Rank counters by count, then text, without interning the ones that lose
+    auto better = [](const Counter* a, const Counter* b) {
+        if (a->count == b->count)
+            return a->token < b->token;
+        return a->count > b->count;
+    };
+    TopK<const Counter*, decltype(better)> top(limit, better);
+    for (const auto& counter : counters)
+        top.push(&counter);
+    // Intern the winners
+    std::vector<std::pair<TokenId, std::size_t>> keywords;
+    for (const Counter* counter : top.take())
+        keywords.emplace_back(vocab.intern(counter->token), counter->count);
+    return keywords;
+}
+
+// Objective :- Report the number of token occurrences counted so far (N in the error bounds)
+// Input :- None
+// Output :- Returns total count
+// Sideeffect :- None
+// Assumption :- None
+std::uint64_t KeywordSketch::total() const {
+    return tokens;
+}
+
+// Objective :- Report the Count-Min error factor e / w (estimates exceed true counts by at most epsilon() * total() with probability 1 - delta())
+// Input :- None
+// Output :- Returns epsilon
+// Sideeffect :- None
+// Assumption :- None
+double KeywordSketch::epsilon() const {
+    return std::exp(1.0) / static_cast<double>(widthMask + 1);
+}
+
+// Objective :- Report the probability e^-d that a Count-Min estimate exceeds its bound
+// Input :- None
+// Output :- Returns delta
+// Sideeffect :- None
+// Assumption :- None
+double KeywordSketch::delta() const {
+    return std::exp(-static_cast<double>(depth));
+}
+
+// Objective :- Report the number of Space-Saving counters k (kept counts overestimate by at most total() / k)
+// Input :- None
+// Output :- Returns k
+// Sideeffect :- None
+// Assumption :- None
+std::size_t KeywordSketch::capacity() const {
+    return slots;
+}
+
+// Objective :- Restore the heap order after the counter at position i grew
+// Input :- i - heap position
+// Output :- None (void function)
+// Sideeffect :- Swaps counters downwards and updates their positions in index
+// Assumption :- Only counters[i] may be out of order
+void KeywordSketch::siftDown(std::size_t i) {
+    const std::size_t n = counters.size();
+    while (true) {
+        // Smallest of the node and its children
+        std::size_t smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < n && counters[left].count < counters[smallest].count)
+            smallest = left;
+        if (right < n && counters[right].count < counters[smallest].count)
+            smallest = right;
+        if (smallest == i)
+            return;
+        std::swap(counters[i], counters[smallest]);
+        index[counters[i].hash] = static_cast<std::uint32_t>(i);
+        index[counters[smallest].hash] = static_cast<std::uint32_t>(smallest);
+        i = smallest;
+    }
+}
+
+// Objective :- Restore the heap order after a counter was appended at position i
+// Input :- i - heap position
+// Output :- None (void function)
+// Sideeffect :- Swaps counters upwards and updates their positions in index
+// Assumption :- Only counters[i] may be out of order
+void KeywordSketch::siftUp(std::size_t i) {
+    while (i > 0) {
+        std::size_t parent = (i - 1) / 2;
+        if (counters[parent].count <= counters[i].count)
+            return;
+        std::swap(counters[i], counters[parent]);
+        index[counters[i].hash] = static_cast<std::uint32_t>(i);
+        index[counters[parent].hash] = static_cast<std::uint32_t>(parent);
+        i = parent;
+    }
+}
@@ -1,67 +1,622 @@
 #include "../include/line_scorer.h"
+#include "../include/flat_hash_map.h"
+#include "../include/parallel.h"
+#include "../include/simd.h"
+#include "../include/top_k.h"
 #include <algorithm>
-#include <string>
-#include <unordered_map>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
 #include <vector>
 
+// Lines summed per simd::lineSums call (the block's sums stay in L1)
+static const std::size_t kScoreBlock = 256;
+
+// Fewest lines per scoring task, so each worker amortizes its heap or sort and the merge stays short
+static const std::size_t kTaskLines = 64 * 1024;
+
+// Cached score of a line that contains a token whose frequency changed (real scores are non-negative, lines without tokens are -1)
+static const float kPending = -2.0f;
+
+// Fewest lines for which rescoreTop keeps state between calls; a full scoreTop of a smaller corpus costs less than building the posting index
+static const std::size_t kIncrementalLines = 256 * 1024;
+
+// Objective :- Represents a run of consecutive lines inside one document arena
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct LineRange {
+    const DocumentArena* doc;   // Arena holding the lines
+    std::size_t first;          // First line within the arena
+    std::size_t count;          // Number of lines
+    std::size_t base;           // Corpus-wide index of the first line
+};
+
+// Objective :- Ranking of scored lines: higher score first, then earlier line
+// Input :- a, b - lines to compare
+// Output :- Returns true if a ranks before b
+// Sideeffect :- None
+// Assumption :- None
+static bool ranksBefore(const ScoredRef& a, const ScoredRef& b) {
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.index < b.index;
+}
+
+// Objective :- Divide every weight by the normalization constant once, so scoring needs no per-token division
+// Input :- keywordWeight - weight of each token ID, maxWeight - weight that normalizes to 1
+// Output :- Returns keywordWeight.size() + 1 normalized weights; the extra zero entry is where simd::lineSums sends unknown IDs
+// Sideeffect :- None
+// Assumption :- maxWeight != 0
+template <typename Weight>
+static std::vector<float> normalizeWeights(const std::vector<Weight>& keywordWeight, double maxWeight) {
+    std::vector<float> normalized(keywordWeight.size() + 1, 0.0f);
+    for (std::size_t id = 0; id < keywordWeight.size(); id++)
+        normalized[id] = static_cast<float>(keywordWeight[id] / maxWeight);
+    return normalized;
+}
+
+// Objective :- Measure the corpus figures the scoring policies are built from
+// Input :- corpus - processed lines
+// Output :- Returns the average number of tokens per line (0 for an empty corpus)
+// Sideeffect :- None
+// Assumption :- None
+static LineStats lineStats(const Corpus& corpus) {
+    // Every arena's last token offset is its token count
+    std::size_t tokens = 0;
+    for (const auto& doc : corpus.documents())
+        if (doc->size() > 0)
+            tokens += doc->tokenOffsets()[doc->size()];
+    LineStats stats;
+    stats.averageTokens = corpus.empty() ? 0.0 : static_cast<double>(tokens) / static_cast<double>(corpus.size());
+    return stats;
+}
+
+// Objective :- Score a run of lines by the normalized weights of their tokens (summed in blocks of lines by simd::lineSums) and their length
+// Input :- policy - scoring formula, normalized - weight table ending in a zero sentinel, sentinel - index of the sentinel, range - lines to score, offer - callable receiving each scored line
+// Output :- None (void function)
+// Sideeffect :- Calls offer once per line with tokens, in line order
+// Assumption :- range lies within its arena
+template <typename Policy, typename Offer>
+static void scoreRange(const Policy& policy, const float* normalized, std::uint32_t sentinel, const LineRange& range, Offer&& offer) {
+    // Per-line weight sums of the current block
+    float sums[kScoreBlock];
+    // Token and offset columns of the document arena
+    const TokenId* tokens = range.doc->tokenData();
+    const std::uint32_t* offsets = range.doc->tokenOffsets();
+    for (std::size_t done = 0; done < range.count; done += kScoreBlock) {
+        // Sum the normalized weights of every line in the block (vectorized gather)
+        std::size_t first = range.first + done;
+        std::size_t count = std::min(kScoreBlock, range.count - done);
+        simd::lineSums(normalized, sentinel, tokens, offsets + first, count, sums);
+
+        for (std::size_t j = 0; j < count; j++) {
+            // Number of tokens of the line
+            std::size_t n = offsets[first + j + 1] - offsets[first + j];
+            // Skip lines with no tokens
+            if (n == 0)
+                continue;
+
+            // Reference the line by index with its score from the policy (inlined)
+            offer(ScoredRef{static_cast<std::uint32_t>(range.base + done + j), policy(sums[j], n)});
+        }
+    }
+}
+
+// Objective :- Score several runs of lines and keep the best 'limit' of them in rank order
+// Input :- policy - scoring formula, normalized - weight table ending in a zero sentinel, sentinel - index of the sentinel, ranges - runs to score, limit - number of best lines to return
+// Output :- Returns vector of at most 'limit' line references sorted by ranksBefore
+// Sideeffect :- Keeps a bounded heap of 'limit' lines (O(n log limit)), or sorts all lines once when limit covers the runs
+// Assumption :- None
+template <typename Policy>
+static std::vector<ScoredRef> selectLines(const Policy& policy, const float* normalized, std::uint32_t sentinel,
+                                          const std::vector<LineRange>& ranges, std::size_t limit) {
+    // Lines offered
+    std::size_t lines = 0;
+    for (const auto& range : ranges)
+        lines += range.count;
+
+    // Best lines so far in a bounded heap, or every line when the limit covers the runs (sorted once at the end)
+    if (limit < lines) {
+        TopK<ScoredRef, bool (*)(const ScoredRef&, const ScoredRef&)> top(limit, ranksBefore);
+        for (const auto& range : ranges)
+            scoreRange(policy, normalized, sentinel, range, [&](const ScoredRef& s) { top.push(s); });
+        return top.take();
+    }
+    std::vector<ScoredRef> scored;
+    scored.reserve(lines);
+    for (const auto& range : ranges)
+        scoreRange(policy, normalized, sentinel, range, [&](const ScoredRef& s) { scored.push_back(s); });
+    std::sort(scored.begin(), scored.end(), ranksBefore);
+    return scored;
+}
+
+// Objective :- Score each processed line by the normalized weights of its tokens and its length under a policy, keeping the best 'limit' lines (shared by the frequency and weight overloads).
+//              Large corpora are split into tasks of at least kTaskLines lines, scored on 'threads' workers and merged; ranksBefore is a total order and a line's score does not depend on its task, so the result is the same for any thread count.
+// Input :- Policy - scoring formula, corpus - processed lines to score, keywordWeight - weight of each token ID (frequency or e.g. TF-IDF), maxWeight - weight that normalizes to 1,
+//           stats - figures the policy is built from (the corpus' own, or the whole corpus' when corpus is one streamed batch), limit - number of best lines to return, threads - worker threads (0 = all cores)
+// Output :- Returns vector of at most 'limit' references to lines of corpus sorted by score descending, earlier lines first on ties
+// Sideeffect :- Builds a normalized weight table (4 bytes per token ID); keeps one bounded heap of 'limit' lines per task, or sorts each task's lines and merges the sorted runs in parallel rounds when limit covers the corpus
+// Assumption :- corpus and keywordWeight may be empty, IDs beyond keywordWeight count as zero; maxWeight = 0 scores nothing
+template <typename Policy, typename Weight>
+static std::vector<ScoredRef> scoreLines(
+    const Corpus& corpus,
+    const std::vector<Weight>& keywordWeight,
+    double maxWeight,
+    const LineStats& stats,
+    std::size_t limit,
+    std::size_t threads) {
+    // Return empty vector if input is empty
+    if (corpus.empty() || keywordWeight.empty() || limit == 0)
+        return {};
+
+    // No token carries any weight
+    if (maxWeight == 0)
+        return {};
+
+    // Normalize the weights once instead of dividing per token
+    const std::uint32_t sentinel = static_cast<std::uint32_t>(keywordWeight.size());
+    std::vector<float> normalized = normalizeWeights(keywordWeight, maxWeight);
+    const Policy policy(stats);
+
+    // Split the corpus into tasks of whole kTaskLines-line runs (a single task when one thread scores, as before)
+    const std::size_t workers = parallel::resolveThreads(threads);
+    const std::size_t taskLines = workers > 1 ? kTaskLines : corpus.size();
+    std::vector<std::vector<LineRange>> tasks(1);
+    std::size_t taskSize = 0, base = 0;
+    for (const auto& doc : corpus.documents()) {
+        for (std::size_t first = 0; first < doc->size();) {
+            // Start a new task once the current one is full
+            if (taskSize >= taskLines) {
+                tasks.emplace_back();
+                taskSize = 0;
+            }
+            std::size_t count = std::min(doc->size() - first, taskLines - taskSize);
+            tasks.back().push_back(LineRange{doc.get(), first, count, base + first});
+            taskSize += count;
+            first += count;
+        }
+        base += doc->size();
+    }
+    if (tasks.size() == 1)
+        return selectLines(policy, normalized.data(), sentinel, tasks[0], limit);
+
+    // Score the tasks on the workers, each into its own sorted run
+    std::vector<std::vector<ScoredRef>> runs(tasks.size());
+    parallel::forEach(tasks.size(), workers, [&](std::size_t t) {
+        runs[t] = selectLines(policy, normalized.data(), sentinel, tasks[t], limit);
+    });
+
+    // Bounded: the best 'limit' lines are among the per-task bests
+    if (limit < corpus.size()) {
+        TopK<ScoredRef, bool (*)(const ScoredRef&, const ScoredRef&)> top(limit, ranksBefore);
+        for (const auto& run : runs)
+            for (const auto& s : run)
+                top.push(s);
+        return top.take();
+    }
+
+    // Unbounded: merge the sorted runs pairwise, each round's merges in parallel
+    while (runs.size() > 1) {
+        std::vector<std::vector<ScoredRef>> merged((runs.size() + 1) / 2);
+        parallel::forEach(merged.size(), workers, [&](std::size_t p) {
+            // An odd run out moves on unchanged
+            if (2 * p + 1 == runs.size()) {
+                merged[p] = std::move(runs[2 * p]);
+                return;
+            }
+            merged[p].reserve(runs[2 * p].size() + runs[2 * p + 1].size());
+            std::merge(runs[2 * p].begin(), runs[2 * p].end(), runs[2 * p + 1].begin(), runs[2 * p + 1].end(),
+                       std::back_inserter(merged[p]), ranksBefore);
+            // Release the inputs as soon as they are merged
+            std::vector<ScoredRef>().swap(runs[2 * p]);
+            std::vector<ScoredRef>().swap(runs[2 * p + 1]);
+        });
+        runs.swap(merged);
+    }
+    return std::move(runs[0]);
+}
+
+// Objective :- Resolve line references into views of the corpus
+// Input :- corpus - corpus the references index into, refs - scored references
+// Output :- Returns one ScoredLine per reference, in the same order
+// Sideeffect :- Creates vector
+// Assumption :- Every index is below corpus.size()
+static std::vector<ScoredLine> resolve(const Corpus& corpus, const std::vector<ScoredRef>& refs) {
+    std::vector<ScoredLine> lines;
+    lines.reserve(refs.size());
+    for (const auto& ref : refs)
+        lines.push_back(ScoredLine{corpus.line(ref.index), ref.score});
+    return lines;
+}
+
 // Objective :- Score each processed line based on keyword frequency and line length, then sort by score descending
-// Input :- lines - vector of ProcessedLine objects to score, keywordFreq - map of keyword frequencies
-// Output :- Returns vector of ScoredLine objects sorted by score in descending order
+// Input :- corpus - processed lines to score (walked one document arena at a time), keywordFreq - frequency of each token ID
+// Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order
 // Sideeffect :- Creates and sorts a vector of ScoredLine objects
-// Assumption :- lines and keywordFreq may be empty, keywordFreq contains at least one entry if not empty
-std::vector<ScoredLine> LineScorer::score(
-    const std::vector<ProcessedLine>& lines,
-    const std::unordered_map<std::string, std::size_t>& keywordFreq) const {
+// Assumption :- corpus and keywordFreq may be empty, IDs beyond keywordFreq count as zero, the arenas outlive the result
+template <typename Policy>
+std::vector<ScoredLine> BasicLineScorer<Policy>::score(
+    const Corpus& corpus,
+    const std::vector<std::uint32_t>& keywordFreq) const {
     
-    // Initialize empty vector to store scored lines
-    std::vector<ScoredLine> scored;
     // Return empty vector if input is empty
-    if (lines.empty() || keywordFreq.empty())
-        return scored;
-
-    // Find maximum frequency value in keyword frequency map
-    const auto maxIt = std::max_element(keywordFreq.begin(), keywordFreq.end(),
-                                        [](auto& a, auto& b) { return a.second < b.second; });
-    // Store maximum frequency for normalization
-    double maxFreq = maxIt->second;
-
-    // Iterate through each processed line
-    for (const auto& line : lines) {
-        // Skip lines with no tokens
-        if (line.tokens.empty())
-            continue;
-
-        // Initialize keyword score accumulator
-        double keywordScore = 0.0;
-        // Calculate keyword score by summing normalized frequencies
-        for (const auto& token : line.tokens) {
-            // Look up token in frequency map
-            auto it = keywordFreq.find(token);
-            // If token is a keyword, add normalized frequency to score
-            if (it != keywordFreq.end())
-                keywordScore += it->second / maxFreq;
+    if (corpus.empty() || keywordFreq.empty())
+        return {};
+
+    // Find maximum frequency value for normalization
+    return resolve(corpus, scoreLines<Policy>(corpus, keywordFreq, *std::max_element(keywordFreq.begin(), keywordFreq.end()), lineStats(corpus), corpus.size(), threads));
+}
+
+// Objective :- score() with caller-supplied normalization figures, for a corpus that is only part of the material (e.g. one streamed batch), so its scores compare with those of the other parts
+// Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, maxFreq - frequency that normalizes to 1 (the corpus-wide maximum), stats - figures of the whole material (e.g. its average line length)
+// Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order
+// Sideeffect :- Creates and sorts a vector of ScoredLine objects
+// Assumption :- corpus and keywordFreq may be empty, IDs beyond keywordFreq count as zero, the arenas outlive the result; maxFreq = 0 scores nothing
+template <typename Policy>
+std::vector<ScoredLine> BasicLineScorer<Policy>::score(
+    const Corpus& corpus,
+    const std::vector<std::uint32_t>& keywordFreq,
+    double maxFreq,
+    const LineStats& stats) const {
+    return resolve(corpus, scoreLines<Policy>(corpus, keywordFreq, maxFreq, stats, corpus.size(), threads));
+}
+
+// Objective :- Score each processed line based on keyword weights (e.g. KeywordExtractor::tfidf) and line length, then sort by score descending
+// Input :- corpus - processed lines to score, keywordWeight - weight of each token ID
+// Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order
+// Sideeffect :- Creates and sorts a vector of ScoredLine objects
+// Assumption :- corpus and keywordWeight may be empty, IDs beyond keywordWeight count as zero, the arenas outlive the result
+template <typename Policy>
+std::vector<ScoredLine> BasicLineScorer<Policy>::score(
+    const Corpus& corpus,
+    const std::vector<float>& keywordWeight) const {
+
+    // Return empty vector if input is empty
+    if (corpus.empty() || keywordWeight.empty())
+        return {};
+
+    // Normalize by the largest weight
+    return resolve(corpus, scoreLines<Policy>(corpus, keywordWeight, *std::max_element(keywordWeight.begin(), keywordWeight.end()), lineStats(corpus), corpus.size(), threads));
+}
+
+// Objective :- Score every processed line but return only the best 'limit' lines, selected with a bounded heap instead of sorting all of them
+// Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, limit - number of lines needed (e.g. QuestionGenerator::linesNeeded)
+// Output :- Returns references (corpus-wide line index and score) to the first 'limit' lines of score(corpus, keywordFreq)
+// Sideeffect :- Keeps a bounded heap of 'limit' 8-byte references
+// Assumption :- Same as score()
+template <typename Policy>
+std::vector<ScoredRef> BasicLineScorer<Policy>::scoreTop(
+    const Corpus& corpus,
+    const std::vector<std::uint32_t>& keywordFreq,
+    std::size_t limit) const {
+
+    // Return empty vector if input is empty
+    if (corpus.empty() || keywordFreq.empty())
+        return {};
+
+    // Find maximum frequency value for normalization
+    return scoreLines<Policy>(corpus, keywordFreq, *std::max_element(keywordFreq.begin(), keywordFreq.end()), lineStats(corpus), limit, threads);
+}
+
+// Objective :- scoreTop() with caller-supplied normalization figures (see the matching score() overload)
+// Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, maxFreq - frequency that normalizes to 1, stats - figures of the whole material, limit - number of lines needed
+// Output :- Returns references to the first 'limit' lines of score(corpus, keywordFreq, maxFreq, stats)
+// Sideeffect :- Keeps a bounded heap of 'limit' 8-byte references
+// Assumption :- Same as score()
+template <typename Policy>
+std::vector<ScoredRef> BasicLineScorer<Policy>::scoreTop(
+    const Corpus& corpus,
+    const std::vector<std::uint32_t>& keywordFreq,
+    double maxFreq,
+    const LineStats& stats,
+    std::size_t limit) const {
+    return scoreLines<Policy>(corpus, keywordFreq, maxFreq, stats, limit, threads);
+}
+
+// Objective :- scoreTop() for keyword weights (see the matching score() overload)
+// Input :- corpus - processed lines to score, keywordWeight - weight of each token ID, limit - number of lines needed
+// Output :- Returns references to the first 'limit' lines of score(corpus, keywordWeight)
+// Sideeffect :- Keeps a bounded heap of 'limit' 8-byte references
+// Assumption :- Same as score()
+template <typename Policy>
+std::vector<ScoredRef> BasicLineScorer<Policy>::scoreTop(
+    const Corpus& corpus,
+    const std::vector<float>& keywordWeight,
+    std::size_t limit) const {
+
+    // Return empty vector if input is empty
+    if (corpus.empty() || keywordWeight.empty())
+        return {};
+
+    // Normalize by the largest weight
+    return scoreLines<Policy>(corpus, keywordWeight, *std::max_element(keywordWeight.begin(), keywordWeight.end()), lineStats(corpus), limit, threads);
+}
+
+// Objective :- Select the best lines of one document from its cached scores
+// Input :- scores - score of each line (negative = no tokens), limit - number of lines to keep
+// Output :- Returns at most 'limit' references (index = line within the document) sorted by ranksBefore
+// Sideeffect :- Keeps a bounded heap of 'limit' lines
+// Assumption :- None
+static std::vector<ScoredRef> bestOf(const std::vector<float>& scores, std::size_t limit) {
+    TopK<ScoredRef, bool (*)(const ScoredRef&, const ScoredRef&)> top(limit, ranksBefore);
+    for (std::size_t i = 0; i < scores.size(); i++)
+        if (scores[i] >= 0)
+            top.push(ScoredRef{static_cast<std::uint32_t>(i), scores[i]});
+    return top.take();
+}
+
+// Objective :- scoreTop() for a corpus that changes by a few documents between calls (e.g. CorpusManifest::lines after a refresh): keeps every line's score, each document's best lines in rank order and a token-to-lines posting index, and rescores only lines that contain a token whose frequency changed or that belong to a new document; all lines are rescored when the largest frequency changes
+//              or the changed tokens' counts reach a quarter of the lines, and corpora under 256k lines are always scored in full without keeping any state
+// Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, limit - number of lines needed
+// Output :- Returns the same references as scoreTop(corpus, keywordFreq, limit)
+// Sideeffect :- On large corpora, updates the cached scores (4 bytes per line), the per-document best lines and, from the first update that changes few enough lines, the posting index (8 bytes per distinct token of each line); holds the document arenas until the next call.
+//               On small ones, releases all of that
+// Assumption :- Documents are recognized by arena, so unchanged documents must be passed as the same arenas (as CorpusManifest does)
+template <typename Policy>
+std::vector<ScoredRef> BasicLineScorer<Policy>::rescoreTop(
+    const Corpus& corpus,
+    const std::vector<std::uint32_t>& keywordFreq,
+    std::size_t limit) {
+
+    // Return empty vector if input is empty
+    if (corpus.empty() || keywordFreq.empty() || limit == 0)
+        return {};
+
+    // Largest frequency normalizes to 1
+    const std::uint32_t maxFreq = *std::max_element(keywordFreq.begin(), keywordFreq.end());
+    if (maxFreq == 0)
+        return {};
+    const Policy policy(lineStats(corpus));
+
+    // Small corpora are scored in full, keeping no state
+    if (corpus.size() < kIncrementalLines) {
+        rankedDocs.clear();
+        rankedFreq.clear();
+        rankedLimit = 0;
+        std::vector<std::vector<LineKey>>().swap(postings);
+        return scoreLines<Policy>(corpus, keywordFreq, maxFreq, lineStats(corpus), limit, threads);
+    }
+
+    // Slot of each live document seen by earlier calls
+    FlatHashMap<const DocumentArena*, std::uint32_t> slotOf;
+    slotOf.reserve(rankedDocs.size());
+    for (std::size_t slot = 0; slot < rankedDocs.size(); slot++)
+        if (rankedDocs[slot].arena)
+            slotOf.insert(rankedDocs[slot].arena.get(), static_cast<std::uint32_t>(slot));
+
+    // Match the corpus documents to known slots; unknown arenas get new slots without scores
+    const std::size_t knownSlots = rankedDocs.size();
+    std::vector<std::uint8_t> kept(knownSlots, 0);
+    std::vector<std::uint32_t> order;
+    order.reserve(corpus.documents().size());
+    std::size_t base = 0, newLines = 0;
+    for (const auto& doc : corpus.documents()) {
+        const std::uint32_t* known = slotOf.find(doc.get());
+        if (known && !kept[*known]) {
+            kept[*known] = 1;
+            rankedDocs[*known].first = base;
+            order.push_back(*known);
+        } else {
+            RankedDocument added;
+            added.arena = doc;
+            added.first = base;
+            added.stale = true;
+            rankedDocs.push_back(std::move(added));
+            order.push_back(static_cast<std::uint32_t>(rankedDocs.size() - 1));
+            newLines += doc->size();
         }
+        base += doc->size();
+    }
 
-        // Calculate keyword density (score per token)
-        double density = keywordScore / line.tokens.size();
-        // Calculate length bonus (capped at 1.0 for lines with 20+ tokens)
-        double lengthBonus = std::min(1.0, (double)line.tokens.size() / 20.0);
-
-        // Create scored line object
-        ScoredLine s;
-        // Store original processed line
-        s.line = line;
-        // Calculate final score: 80% density + 20% length bonus
-        s.score = density * 0.8 + lengthBonus * 0.2;
-        // Add scored line to vector
-        scored.push_back(std::move(s));
+    // Release documents that left the corpus; their posting entries are dropped when next visited
+    std::size_t removed = 0;
+    for (std::size_t slot = 0; slot < knownSlots; slot++) {
+        if (!kept[slot])
+            rankedDocs[slot] = RankedDocument();
+        if (!rankedDocs[slot].arena)
+            removed++;
+    }
+    // Once removed documents outnumber live ones, compact the slots and index the documents again when next needed
+    if (removed > order.size()) {
+        std::vector<RankedDocument> live;
+        live.reserve(order.size());
+        for (std::uint32_t& slot : order) {
+            live.push_back(std::move(rankedDocs[slot]));
+            live.back().indexed = false;
+            slot = static_cast<std::uint32_t>(live.size() - 1);
+        }
+        rankedDocs.swap(live);
+        postings.clear();
     }
 
-    // Sort scored lines by score in descending order
-    std::sort(scored.begin(), scored.end(),
-              [](auto& a, auto& b) { return a.score > b.score; });
+    // Rescore everything when the normalization or the policy's corpus figures change (or on the first call)
+    bool rescoreAll = rankedFreq.empty() || *std::max_element(rankedFreq.begin(), rankedFreq.end()) != maxFreq ||
+                      !(policy == rankedPolicy);
+    if (!rescoreAll && rankedFreq != keywordFreq) {
+        // A token is on at most as many lines as its count, so the counts of the changed tokens bound the lines to rescore before any index exists
+        std::size_t fanOut = 0;
+        const std::size_t tokens = std::max(keywordFreq.size(), rankedFreq.size());
+        for (std::size_t token = 0; token < tokens; token++) {
+            std::uint32_t before = token < rankedFreq.size() ? rankedFreq[token] : 0;
+            std::uint32_t now = token < keywordFreq.size() ? keywordFreq[token] : 0;
+            if (before != now)
+                fanOut += std::max(before, now);
+        }
+        // Edits touching common words reach a large share of the lines: rescore them all without building (or walking) the posting index
+        rescoreAll = fanOut * 4 > corpus.size();
+    }
+    if (!rescoreAll && rankedFreq != keywordFreq) {
+        // Index the documents not in the posting index yet (all of them on the first incremental call, new ones afterwards)
+        if (postings.empty()) {
+            // A token occurs on at most as many lines as its count
+            postings.resize(keywordFreq.size());
+            for (std::size_t token = 0; token < keywordFreq.size(); token++)
+                postings[token].reserve(keywordFreq[token]);
+        }
+        for (std::uint32_t slot : order)
+            if (!rankedDocs[slot].indexed)
+                indexDocument(slot);
 
-    // Return sorted scored lines
-    return scored;
+        // Tokens whose frequency changed, and how many line entries they would visit
+        std::vector<std::uint32_t> changed;
+        std::size_t visits = 0;
+        const std::size_t tokens = std::min(std::max(keywordFreq.size(), rankedFreq.size()), postings.size());
+        for (std::size_t token = 0; token < tokens; token++) {
+            std::uint32_t before = token < rankedFreq.size() ? rankedFreq[token] : 0;
+            std::uint32_t now = token < keywordFreq.size() ? keywordFreq[token] : 0;
+            if (before != now) {
+                changed.push_back(static_cast<std::uint32_t>(token));
+                visits += postings[token].size();
+            }
+        }
+
+        // Mark every scored line containing a changed token (skipped when common tokens changed, which touches most lines; stops once half the corpus needs rescoring)
+        std::size_t dirtyLines = visits > 2 * corpus.size() ? corpus.size() : newLines;
+        for (std::size_t c = 0; c < changed.size() && dirtyLines * 2 <= corpus.size(); c++) {
+            // Visit the token's lines, dropping entries of removed documents
+            std::vector<LineKey>& lines = postings[changed[c]];
+            std::size_t live = 0;
+            for (const LineKey& key : lines) {
+                RankedDocument& doc = rankedDocs[key.doc];
+                if (!doc.arena)
+                    continue;
+                lines[live++] = key;
+                // New documents are scored in full anyway
+                if (doc.scores.empty())
+                    continue;
+                float& score = doc.scores[key.line];
+                dirtyLines += score != kPending;
+                score = kPending;
+                doc.stale = true;
+            }
+            lines.resize(live);
+        }
+        // Rescoring most lines costs no less than rescoring all of them
+        rescoreAll = dirtyLines * 2 > corpus.size();
+    }
+
+    // Documents whose scores are dropped, or whose best lists are too short for this limit, are rebuilt
+    const bool longer = limit > rankedLimit;
+    rankedLimit = std::max(rankedLimit, limit);
+    std::vector<std::uint32_t> stale;
+    for (std::uint32_t slot : order) {
+        RankedDocument& doc = rankedDocs[slot];
+        if (rescoreAll)
+            doc.scores.clear();
+        if (rescoreAll || longer || doc.stale)
+            stale.push_back(slot);
+    }
+
+    // Score what is missing and rebuild the best lists, one document per task
+    const std::uint32_t sentinel = static_cast<std::uint32_t>(keywordFreq.size());
+    std::vector<float> normalized = stale.empty() ? std::vector<float>() : normalizeWeights(keywordFreq, maxFreq);
+    parallel::forEach(stale.size(), threads, [&](std::size_t t) {
+        RankedDocument& doc = rankedDocs[stale[t]];
+        const std::size_t lines = doc.arena->size();
+        auto record = [&](const ScoredRef& s) { doc.scores[s.index] = s.score; };
+        if (doc.scores.size() != lines) {
+            // Every line (lines without tokens stay negative), selecting the best ones in the same pass
+            doc.scores.assign(lines, -1.0f);
+            TopK<ScoredRef, bool (*)(const ScoredRef&, const ScoredRef&)> top(rankedLimit, ranksBefore);
+            scoreRange(policy, normalized.data(), sentinel, LineRange{doc.arena.get(), 0, lines, 0}, [&](const ScoredRef& s) {
+                doc.scores[s.index] = s.score;
+                top.push(s);
+            });
+            doc.best = top.take();
+            doc.stale = false;
+            return;
+        }
+        // Runs of consecutive lines awaiting rescoring
+        for (std::size_t i = 0; i < lines;) {
+            if (doc.scores[i] != kPending) {
+                i++;
+                continue;
+            }
+            std::size_t end = i;
+            while (end < lines && doc.scores[end] == kPending)
+                doc.scores[end++] = -1.0f;
+            scoreRange(policy, normalized.data(), sentinel, LineRange{doc.arena.get(), i, end - i, i}, record);
+            i = end;
+        }
+        doc.best = bestOf(doc.scores, rankedLimit);
+        doc.stale = false;
+    });
+
+    // Remember what the cached scores describe
+    rankedFreq = keywordFreq;
+    rankedPolicy = policy;
+
+    // Merge the documents' best lists; each list is in rank order, so a document stops at its first line that does not make the cut
+    TopK<ScoredRef, bool (*)(const ScoredRef&, const ScoredRef&)> top(limit, ranksBefore);
+    for (std::uint32_t slot : order) {
+        const RankedDocument& doc = rankedDocs[slot];
+        for (const ScoredRef& ref : doc.best)
+            if (!top.push(ScoredRef{static_cast<std::uint32_t>(doc.first + ref.index), ref.score}))
+                break;
+    }
+    return top.take();
+}
+
+// Objective :- Add the lines of one document to the posting index
+// Input :- slot - slot of the document in rankedDocs
+// Output :- None (void function)
+// Sideeffect :- Appends one entry per distinct token of each line to postings; marks the document indexed
+// Assumption :- The document is live and not yet indexed
+template <typename Policy>
+void BasicLineScorer<Policy>::indexDocument(std::uint32_t slot) {
+    RankedDocument& doc = rankedDocs[slot];
+    for (std::size_t i = 0; i < doc.arena->size(); i++) {
+        LineKey key{slot, static_cast<std::uint32_t>(i)};
+        for (TokenId token : doc.arena->line(i).tokens) {
+            if (token >= postings.size())
+                postings.resize(token + 1);
+            // A repeated token of the same line finds its own entry last in the list
+            std::vector<LineKey>& lines = postings[token];
+            if (lines.empty() || lines.back().doc != key.doc || lines.back().line != key.line)
+                lines.push_back(key);
+        }
+    }
+    doc.indexed = true;
+}
+
+// Objective :- Set the number of worker threads used to score large corpora (results do not depend on it)
+// Input :- count - number of threads (0 means one per hardware thread, 1 scores on the calling thread)
+// Output :- None (void function)
+// Sideeffect :- Updates member variable threads
+// Assumption :- None
+template <typename Policy>
+void BasicLineScorer<Policy>::setThreads(std::size_t count) {
+    // Store thread count
+    threads = count;
 }
 
+// Built-in policies
+template class BasicLineScorer<DensityPolicy>;
+template class BasicLineScorer<Bm25Policy>;
+template class BasicLineScorer<TfidfSumPolicy>;
+
+// Objective :- Create the line scorer for a scoring policy chosen at run time
+// Input :- policy - scoring formula, threads - worker threads for scoring (0 = all cores)
+// Output :- Returns the scorer
+// Sideeffect :- None
+// Assumption :- None
+AnyLineScorer makeLineScorer(ScorePolicy policy, std::size_t threads) {
+    AnyLineScorer scorer;
+    switch (policy) {
+    case ScorePolicy::Bm25:
+        scorer.emplace<Bm25LineScorer>();
+        break;
+    case ScorePolicy::TfidfSum:
+        scorer.emplace<TfidfSumLineScorer>();
+        break;
+    default:
+        // Density, also for TextRank where a LineScorer is still needed (streaming, and graphs without links)
+        scorer.emplace<LineScorer>();
+        break;
+    }
+    // Same thread count whichever scorer was chosen
+    std::visit([&](auto& chosen) { chosen.setThreads(threads); }, scorer);
+    return scorer;
+}
@@ -1,31 +1,260 @@
 #include "../include/document.h"
+#include "../include/corpus.h"
+#include "../include/corpus_manifest.h"
 #include "../include/file_manager.h"
 #include "../include/preprocessor.h"
 #include "../include/keyword_extractor.h"
+#include "../include/keyphrase_extractor.h"
+#include "../include/keyword_sketch.h"
 #include "../include/line_scorer.h"
 #include "../include/question_generator.h"
 #include "../include/paper_exporter.h"
 #include "../include/ui.h"
+#include "../include/options.h"
+#include "../include/stream_pipeline.h"
+#include "../include/stopword_table.h"
+#include "../include/text_ranker.h"
+#include "../include/vocabulary.h"
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Objective :- Resolve line references into views of the corpus they index into
+// Input :- corpus - corpus of the references, refs - scored references
+// Output :- Returns one ScoredLine per reference, in the same order
+// Sideeffect :- Creates vector
+// Assumption :- Every index is below corpus.size()
+static std::vector<ScoredLine> viewLines(const Corpus& corpus, const std::vector<ScoredRef>& refs) {
+    std::vector<ScoredLine> lines;
+    lines.reserve(refs.size());
+    for (const auto& ref : refs)
+        lines.push_back(ScoredLine{corpus.line(ref.index), ref.score});
+    return lines;
+}
+
+// Objective :- Publish the best lines of a streaming run as a one-document corpus with references in rank order
+// Input :- arena - storage of the best lines in rank order, scored - the best lines (viewing arena), lines - receives the corpus, ranked - receives the references
+// Output :- None (void function)
+// Sideeffect :- Replaces lines and ranked
+// Assumption :- scored[i] views arena->line(i)
+static void publishLines(std::shared_ptr<const DocumentArena> arena, const std::vector<ScoredLine>& scored,
+                         Corpus& lines, std::vector<ScoredRef>& ranked) {
+    lines.clear();
+    ranked.clear();
+    if (!arena)
+        return;
+    lines.add(std::move(arena));
+    for (std::size_t i = 0; i < scored.size(); i++)
+        ranked.push_back(ScoredRef{static_cast<std::uint32_t>(i), static_cast<float>(scored[i].score)});
+}
+
+// Objective :- Build keywords and the best-scoring lines by streaming the corpus twice under a memory budget: once to count tokens, once to score lines while keeping only the best ones
+// Input :- fm - file manager for the input path, pre - preprocessor, vocab - vocabulary pre interns into, ex - keyword extractor, scorer - line scorer, opts - command-line options (budget and threads), keep - number of best lines to keep, keywords - receives ranked keyword IDs, lines - receives the best lines, ranked - receives references into lines sorted by score
+// Output :- Returns false if the path is invalid or has no usable text, true otherwise
+// Sideeffect :- Runs the streaming pipeline twice, writes streaming statistics to standard output
+// Assumption :- keep > 0; scorer is a BasicLineScorer
+template <typename Scorer>
+static bool streamCorpus(const FileManager& fm, Preprocessor& pre, const Vocabulary& vocab,
+                         const KeywordExtractor& ex, const Scorer& scorer, const Options& opts,
+                         std::size_t keep, std::vector<std::pair<TokenId, std::size_t>>& keywords,
+                         Corpus& lines, std::vector<ScoredRef>& ranked) {
+    // Pipeline with the configured budget (given in megabytes)
+    StreamPipeline pipeline(pre, opts.streamBudgetMb * 1024 * 1024, opts.threads);
+
+    // First pass: count tokens while load, preprocess and count overlap
+    std::vector<std::uint32_t> freq;
+    StreamPipeline::Stats stats;
+    if (!pipeline.countTokens(fm, ex, freq, &stats) || freq.empty())
+        return false;
+    ui::reportStream(stats.lines, stats.bytes, stats.peakBytes, stats.seconds);
+
+    // Extract top 100 keywords based on frequency
+    keywords = ex.topKeywords(freq, vocab, 100);
+
+    // Normalize every batch by the whole corpus (largest frequency, average line length), so scores of different batches compare
+    std::uint64_t tokens = 0;
+    for (std::uint32_t count : freq)
+        tokens += count;
+    const double maxFreq = *std::max_element(freq.begin(), freq.end());
+    LineStats corpusStats;
+    corpusStats.averageTokens = stats.lines > 0 ? static_cast<double>(tokens) / static_cast<double>(stats.lines) : 0.0;
+
+    // Second pass: score each batch and merge it into the running best lines
+    auto byScore = [](const ScoredLine& a, const ScoredLine& b) { return a.score > b.score; };
+    // Best lines so far and the arena owning their text (each batch is released after it is consumed)
+    std::vector<ScoredLine> scored;
+    std::shared_ptr<const DocumentArena> best;
+    pipeline.run(fm, [&](std::vector<ProcessedLine>& batchLines) {
+        Corpus batchCorpus;
+        batchCorpus.add(std::make_shared<const DocumentArena>(batchLines));
+        auto batch = viewLines(batchCorpus, scorer.scoreTop(batchCorpus, freq, maxFreq, corpusStats, keep));
+        std::vector<ScoredLine> merged;
+        merged.reserve(scored.size() + batch.size());
+        std::merge(scored.begin(), scored.end(), batch.begin(), batch.end(),
+                   std::back_inserter(merged), byScore);
+        if (merged.size() > keep)
+            merged.resize(keep);
+        // Copy the surviving lines into a fresh arena and point the results at it
+        auto kept = std::make_shared<DocumentArena>();
+        for (const auto& s : merged)
+            kept->append(s.line);
+        for (std::size_t i = 0; i < merged.size(); i++)
+            merged[i].line = kept->line(i);
+        best = std::move(kept);
+        scored = std::move(merged);
+    });
+    // Hand the best lines to the caller
+    publishLines(std::move(best), scored, lines, ranked);
+    return true;
+}
+
+// Objective :- Represents one of the best lines kept while streaming with approximate counts, with the vocabulary its token IDs refer to
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct KeptLine {
+    ScoredLine scored;             // Line view and score
+    const Vocabulary* vocab{};     // Vocabulary of the line's token IDs
+};
+
+// Objective :- Copy lines into a fresh arena, re-interning their tokens into one vocabulary
+// Input :- lines - lines with the vocabulary each one refers to, target - vocabulary the copies refer to, scored - receives views of the copies with their scores
+// Output :- Returns the arena holding the copies
+// Sideeffect :- Interns the lines' tokens into target
+// Assumption :- No line points into target's storage; the source vocabularies are alive
+static std::shared_ptr<const DocumentArena> copyLines(const std::vector<KeptLine>& lines, Vocabulary& target,
+                                                      std::vector<ScoredLine>& scored) {
+    auto arena = std::make_shared<DocumentArena>();
+    std::vector<TokenId> ids;
+    for (const auto& kept : lines) {
+        // Re-intern the tokens and copy the line with the new IDs
+        ids.clear();
+        for (TokenId token : kept.scored.line.tokens)
+            ids.push_back(target.intern(kept.vocab->text(token)));
+        LineView line = kept.scored.line;
+        line.tokens = TokenSpan{ids.data(), ids.size()};
+        arena->append(line);
+    }
+    // Point the results at the copies
+    scored.clear();
+    for (std::size_t i = 0; i < lines.size(); i++)
+        scored.push_back(ScoredLine{arena->line(i), lines[i].scored.score});
+    return arena;
+}
+
+// Objective :- streamCorpus() with approximate counts: token frequencies live in a fixed-size sketch and every batch is tokenized against its own vocabulary, so memory does not grow with the corpus
+// Input :- fm - file manager for the input path, pre - preprocessor, vocab - vocabulary receiving the keywords and the tokens of the best lines, scorer - line scorer, opts - command-line options (budgets and threads), keep - number of best lines to keep, keywords - receives ranked keyword IDs, lines - receives the best lines, ranked - receives references into lines sorted by score
+// Output :- Returns false if the path is invalid or has no usable text, true otherwise
+// Sideeffect :- Runs the streaming pipeline twice, writes streaming statistics and error bounds to standard output
+// Assumption :- keep > 0; scorer is a BasicLineScorer
+template <typename Scorer>
+static bool streamCorpusApprox(const FileManager& fm, Preprocessor& pre, Vocabulary& vocab,
+                               const Scorer& scorer, const Options& opts, std::size_t keep,
+                               std::vector<std::pair<TokenId, std::size_t>>& keywords,
+                               Corpus& lines, std::vector<ScoredRef>& ranked) {
+    // Pipeline with the configured budget (given in megabytes)
+    StreamPipeline pipeline(pre, opts.streamBudgetMb * 1024 * 1024, opts.threads);
+
+    // First pass: count tokens into the sketch
+    KeywordSketch sketch(opts.approxCountsMb * 1024 * 1024);
+    StreamPipeline::Stats stats;
+    if (!pipeline.countTokens(fm, sketch, &stats) || sketch.total() == 0)
+        return false;
+    ui::reportStream(stats.lines, stats.bytes, stats.peakBytes, stats.seconds);
+    ui::reportSketch(sketch.total(), sketch.capacity(), sketch.epsilon(), sketch.delta());
+
+    // Extract top 100 keywords from the heavy hitters (only these enter the shared vocabulary)
+    keywords = sketch.topKeywords(vocab, 100);
+
+    // Second pass: score each batch with estimated frequencies, normalized by the whole corpus (largest count, average line length), and merge it into the running best lines
+    const double maxFreq = sketch.maxCount();
+    LineStats corpusStats;
+    corpusStats.averageTokens = stats.lines > 0 ? static_cast<double>(sketch.total()) / static_cast<double>(stats.lines) : 0.0;
+    // Best lines so far, their arena and the vocabulary their tokens refer to (rebuilt with every batch)
+    std::vector<ScoredLine> best;
+    std::shared_ptr<const DocumentArena> bestArena;
+    auto bestVocab = std::make_unique<Vocabulary>();
+    pipeline.run(fm, [&](std::vector<ProcessedLine>& batchLines) {
+        // Tokenize the batch against its own vocabulary and look up each distinct token once
+        Vocabulary local;
+        pre.internTokens(batchLines, local);
+        std::vector<std::uint32_t> freq(local.size());
+        for (std::size_t id = 0; id < freq.size(); id++)
+            freq[id] = sketch.estimate(local.text(static_cast<TokenId>(id)));
+        Corpus batchCorpus;
+        batchCorpus.add(std::make_shared<const DocumentArena>(batchLines));
+        auto batch = viewLines(batchCorpus, scorer.scoreTop(batchCorpus, freq, maxFreq, corpusStats, keep));
+
+        // Merge (earlier lines first on ties) and truncate, remembering which vocabulary each line uses
+        std::vector<KeptLine> merged;
+        std::size_t a = 0, b = 0;
+        while (merged.size() < keep && (a < best.size() || b < batch.size())) {
+            if (a == best.size() || (b < batch.size() && batch[b].score > best[a].score))
+                merged.push_back(KeptLine{batch[b++], &local});
+            else
+                merged.push_back(KeptLine{best[a++], bestVocab.get()});
+        }
+        // Copy the survivors with their tokens in a fresh vocabulary, so only their words are retained
+        auto kept = std::make_unique<Vocabulary>();
+        bestArena = copyLines(merged, *kept, best);
+        bestVocab = std::move(kept);
+    }, nullptr, false);
+
+    // Move the best lines into the shared vocabulary the keywords refer to
+    std::vector<KeptLine> survivors;
+    for (const auto& s : best)
+        survivors.push_back(KeptLine{s, bestVocab.get()});
+    std::vector<ScoredLine> scored;
+    auto arena = copyLines(survivors, vocab, scored);
+    publishLines(std::move(arena), scored, lines, ranked);
+    return true;
+}
 
 // Objective :- Main entry point of the question paper generator application. Manages the application flow, user interaction, and coordinates all components to generate question papers from text documents.
-// Input :- None (reads from standard input)
-// Output :- Returns 0 on successful program termination
+// Input :- argc, argv - command-line options (see parseOptions), then reads from standard input
+// Output :- Returns 0 on successful program termination, 1 on invalid command-line options or an unreadable stopword file
 // Sideeffect :- Reads user input from console, writes output to console and files, creates FileManager, Preprocessor, KeywordExtractor, LineScorer, QuestionGenerator, and PaperExporter objects
-int main() {
+int main(int argc, char* argv[]) {
+
+    // Parse command-line tuning options
+    Options opts = parseOptions(argc, argv);
+
+    // Stop on invalid options
+    if (!opts.ok)
+        return 1;
+
+    // Built-in stopwords plus the optional custom list
+    StopwordTable stopwords;
+    if (!opts.stopwordsPath.empty() && !stopwords.loadFile(opts.stopwordsPath))
+        return 1;
 
     // Display welcome banner to the user
     ui::printBanner();
 
-    // Initialize preprocessor to clean and tokenize text
-    Preprocessor pre;
+    // Vocabulary shared by all stages: tokens are interned to integer IDs once and rendered as text only in questions
+    Vocabulary vocab;
+
+    // Initialize preprocessor to clean, tokenize and intern text
+    Preprocessor pre(vocab, stopwords);
 
     // Initialize keyword extractor to find important terms
     KeywordExtractor ex;
 
-    // Initialize line scorer to rank lines by importance
-    LineScorer scorer;
+    // Initialize keyphrase extractor to find repeated multi-word terms
+    KeyphraseExtractor phraser(opts.phraseLength);
+
+    // Initialize line scorer with the configured formula to rank lines by importance, on the configured number of threads
+    AnyLineScorer scorer = makeLineScorer(opts.scoring, opts.threads);
+
+    // Initialize TextRank ranker to rank lines by centrality instead (when the whole corpus is loaded), on the configured number of threads
+    TextRanker ranker;
+    ranker.setThreads(opts.threads);
 
     // Initialize question generator to create questions
     QuestionGenerator gen;
@@ -33,6 +262,12 @@ int main() {
     // Initialize paper exporter to save questions to file
     PaperExporter exporter;
 
+    // Manifest caching processed lines and token counts between runs so unchanged files are not reprocessed
+    CorpusManifest manifest;
+
+    // Manifest generation the vocabulary and the scorer state were built for
+    std::size_t vocabGeneration = manifest.generation();
+
     // Main application loop - continues until user chooses to exit
     while (true) {
 
@@ -73,37 +308,136 @@ int main() {
         // Create file manager with user-provided path
         FileManager fm(folder);
 
-        // Load all text documents from the specified path
-        auto docs = fm.loadDocuments();
+        // Use the configured number of loader threads
+        fm.setThreads(opts.threads);
 
-        // Check if any documents were loaded
-        if (docs.empty()) {
+        // Keywords and ranked lines (references into 'source') the paper is generated from
+        std::vector<std::pair<TokenId, std::size_t>> keywords;
+        std::vector<ScoredRef> ranked;
 
-            // Display error message if no files found
-            std::cout << "No .txt files found!\n";
+        // Keywords as text: multi-word keyphrases first (found only when the whole corpus is loaded), then single keywords
+        std::vector<std::pair<std::string, std::size_t>> terms;
 
-            // Continue to next iteration of loop
-            continue;
+        // Best lines when streaming (otherwise the manifest's corpus holds them) and the corpus the ranked lines index into
+        Corpus streamed;
+        const Corpus* source = &streamed;
 
-        }
+        if (opts.streamBudgetMb > 0) {
+
+            // Nothing is cached between streaming runs, so each one starts from an empty vocabulary instead of growing it with every folder visited
+            vocab = Vocabulary();
+
+            // Stream the corpus with bounded memory instead of materializing it (with approximate counts if requested)
+            bool found = std::visit([&](const auto& chosen) {
+                return opts.approxCountsMb > 0
+                    ? streamCorpusApprox(fm, pre, vocab, chosen, opts, gen.linesNeeded(), keywords, streamed, ranked)
+                    : streamCorpus(fm, pre, vocab, ex, chosen, opts, gen.linesNeeded(), keywords, streamed, ranked);
+            }, scorer);
+            if (!found) {
+
+                // Display error message if no files found
+                std::cout << "No .txt files found!\n";
+
+                // Continue to next iteration of loop
+                continue;
 
-        // Process all documents to clean and tokenize text
-        auto processed = pre.process(docs);
+            }
 
-        // Collect all tokens from processed lines
-        auto tokens = pre.collectTokens(processed);
+        } else {
 
-        // Calculate frequency of each token
-        auto freq = ex.frequency(tokens);
+            // Load only documents that are new or changed since the previous run
+            FileManager::LoadStats loadStats;
+            auto docs = fm.refresh(manifest, &loadStats);
 
-        // Extract top 100 keywords based on frequency
-        auto keywords = ex.topKeywords(freq, 100);
+            // A different folder dropped every cached document, and with them every use of the previous token IDs: start a fresh vocabulary and scorer
+            // so the ID-indexed tables (counts, weights, the incremental rescoring index) are sized by this folder, not by every folder visited
+            if (manifest.generation() != vocabGeneration) {
+                vocabGeneration = manifest.generation();
+                vocab = Vocabulary();
+                scorer = makeLineScorer(opts.scoring, opts.threads);
+            }
 
-        // Score each processed line based on keyword frequency
-        auto scored = scorer.score(processed, freq);
+            // Clean and tokenize changed documents across cores
+            auto results = pre.processEach(docs, opts.threads);
+
+            // Count their tokens across cores
+            auto counts = ex.countEach(results, opts.threads);
+
+            // Replace the documents' cached results and merge their counts into the manifest
+            for (std::size_t i = 0; i < docs.size(); i++)
+                manifest.update(docs[i].name, std::move(results[i]), std::move(counts[i]));
+
+            // Check if any documents are available
+            if (manifest.empty()) {
+
+                // Display error message if no files found
+                std::cout << "No .txt files found!\n";
+
+                // Continue to next iteration of loop
+                continue;
+
+            }
+
+            // Display load throughput
+            ui::reportLoad(loadStats.files, loadStats.bytes, loadStats.seconds, loadStats.unchanged);
+
+            // Processed lines of the whole corpus (cached documents included)
+            const auto& processed = manifest.lines();
+            source = &processed;
+
+            // Frequency of each token across the whole corpus
+            const auto& freq = manifest.frequency();
+
+            // Extract top 100 repeated keyphrases from the token stream
+            if (opts.phraseLength > 1)
+                terms = phraser.topPhrases(processed, vocab, 100);
+
+            // Rank the lines by how central they are to the material, keeping only the lines the paper uses
+            bool centrality = false;
+            if (opts.scoring == ScorePolicy::TextRank) {
+
+                TextRanker::RankStats rankStats;
+                ranked = ranker.scoreTop(processed, gen.linesNeeded(), &rankStats);
+
+                // Display graph size and ranking time
+                ui::reportRank(rankStats.lines, rankStats.edges, rankStats.iterations, rankStats.seconds);
+
+                // Without links every line ranks the same, so the order would only be corpus order; score by keywords instead
+                centrality = rankStats.edges > 0;
+                if (!centrality)
+                    std::cout << "No lines share words to link; scoring lines by keyword density instead.\n";
+
+            }
+
+            if (opts.tfidf) {
+
+                // Weight tokens by TF-IDF from the per-document counts the manifest already merged
+                auto weight = ex.tfidf(freq, manifest.documentFrequency(), manifest.documentCount());
+
+                // Extract top 100 keywords based on TF-IDF weight
+                keywords = ex.topKeywords(weight, freq, vocab, 100);
+
+                // Score each processed line based on keyword weight, keeping only the lines the paper uses
+                if (!centrality)
+                    ranked = std::visit([&](const auto& chosen) { return chosen.scoreTop(processed, weight, gen.linesNeeded()); }, scorer);
+
+            } else {
+
+                // Extract top 100 keywords based on frequency
+                keywords = ex.topKeywords(freq, vocab, 100);
+
+                // Score each processed line based on keyword frequency, keeping only the lines the paper uses (with --incremental, rescoring only lines whose keyword counts changed since the previous run)
+                if (!centrality && opts.incremental)
+                    ranked = std::visit([&](auto& chosen) { return chosen.rescoreTop(processed, freq, gen.linesNeeded()); }, scorer);
+                else if (!centrality)
+                    ranked = std::visit([&](const auto& chosen) { return chosen.scoreTop(processed, freq, gen.linesNeeded()); }, scorer);
+
+            }
+
+        }
 
         // Check if scoring was successful
-        if (scored.empty()) {
+        if (ranked.empty()) {
 
             // Display error message if scoring failed
             std::cout << "Unable to score lines!\n";
@@ -113,8 +447,12 @@ int main() {
 
         }
 
+        // Keyphrases first, then single keywords
+        for (const auto& k : keywords)
+            terms.emplace_back(vocab.text(k.first), k.second);
+
         // Generate question paper from scored lines and keywords
-        auto paper = gen.generate(scored, keywords);
+        auto paper = gen.generate(*source, ranked, terms, vocab);
 
         // Display summary of generated questions
         ui::summarize(paper);
@@ -0,0 +1,129 @@
+#include "../include/options.h"
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Most worker threads a command line may ask for (larger counts are clamped; one table or thread is allocated per worker)
+static const std::size_t kMaxThreads = 1024;
+
+// Largest budget in MB (1 TB), so budgets converted to bytes cannot overflow
+static const std::size_t kMaxBudgetMb = std::size_t(1) << 20;
+
+// Longest keyphrase in words (the extractor stores common-prefix lengths in one byte)
+static const std::size_t kMaxPhraseLength = 255;
+
+// Objective :- Parse a non-negative integer argument value
+// Input :- text - string containing the value, out - reference receiving the parsed number, max - largest accepted value
+// Output :- Returns true if text is a complete non-negative integer no larger than max, false otherwise (including values out of range for strtoull)
+// Sideeffect :- Writes parsed value to out on success
+// Assumption :- None
+static bool parseCount(const std::string& text, std::size_t& out, std::size_t max) {
+    // Reject empty strings and signs
+    if (text.empty() || text[0] == '-' || text[0] == '+')
+        return false;
+    // Parse the number and require the whole string to be consumed
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || value > max)
+        return false;
+    // Store parsed value
+    out = static_cast<std::size_t>(value);
+    return true;
+}
+
+// Objective :- Parse a line scoring policy name
+// Input :- text - policy name, out - reference receiving the policy
+// Output :- Returns true if text names a policy, false otherwise
+// Sideeffect :- Writes the policy to out on success
+// Assumption :- None
+static bool parsePolicy(const std::string& text, ScorePolicy& out) {
+    if (text == "density")
+        out = ScorePolicy::Density;
+    else if (text == "bm25")
+        out = ScorePolicy::Bm25;
+    else if (text == "tfidf-sum")
+        out = ScorePolicy::TfidfSum;
+    else if (text == "textrank")
+        out = ScorePolicy::TextRank;
+    else
+        return false;
+    return true;
+}
+
+// Objective :- Print command-line usage to standard error
+// Input :- program - name the program was invoked with
+// Output :- None (void function)
+// Sideeffect :- Writes usage text to cerr
+// Assumption :- program is a valid C string
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --threads N        worker threads for loading, processing and scoring (0 = all cores, at most 1024)\n"
+              << "  --stream-budget M  stream the corpus using at most about M MB for text in flight (up to 1048576)\n"
+              << "  --stopwords FILE   add the whitespace-separated words in FILE to the built-in stopwords\n"
+              << "  --phrase-length N  longest multi-word keyphrase to ask about (default 4, 1 = single words only)\n"
+              << "  --approx-counts M  count keywords approximately in M MB while streaming (implies --stream-budget 64)\n"
+              << "  --tfidf            rank keywords by TF-IDF so words common to every file weigh less\n"
+              << "  --scoring NAME     line scoring formula: density (default), bm25, tfidf-sum (implies --tfidf) or textrank\n"
+              << "  --incremental      between runs on a large folder, rescore only lines whose keyword counts changed\n";
+}
+
+// Objective :- Parse command-line arguments into an Options structure
+// Input :- argc - argument count, argv - argument values as passed to main
+// Output :- Returns Options with parsed settings; ok is false on unknown or malformed arguments
+// Sideeffect :- Writes error and usage messages to cerr on invalid arguments
+// Assumption :- argv holds argc valid C strings
+Options parseOptions(int argc, char* argv[]) {
+    // Start from defaults
+    Options opts;
+    // Walk through arguments after the program name
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        // Fetch the value following an option, if any
+        std::string value = (i + 1 < argc) ? argv[i + 1] : "";
+
+        if (arg == "--threads" && parseCount(value, opts.threads, static_cast<std::size_t>(-1))) {
+            // Clamp to a sane pool size and consume the value
+            if (opts.threads > kMaxThreads)
+                opts.threads = kMaxThreads;
+            i++;
+        } else if (arg == "--stream-budget" && parseCount(value, opts.streamBudgetMb, kMaxBudgetMb) && opts.streamBudgetMb > 0) {
+            // Consume the value
+            i++;
+        } else if (arg == "--phrase-length" && parseCount(value, opts.phraseLength, kMaxPhraseLength) && opts.phraseLength > 0) {
+            // Consume the value
+            i++;
+        } else if (arg == "--approx-counts" && parseCount(value, opts.approxCountsMb, kMaxBudgetMb) && opts.approxCountsMb > 0) {
+            // Consume the value
+            i++;
+        } else if (arg == "--tfidf") {
+            // Flag without a value
+            opts.tfidf = true;
+        } else if (arg == "--incremental") {
+            // Flag without a value
+            opts.incremental = true;
+        } else if (arg == "--scoring" && parsePolicy(value, opts.scoring)) {
+            // Consume the value
+            i++;
+        } else if (arg == "--stopwords" && !value.empty()) {
+            // Store the path and consume the value
+            opts.stopwordsPath = value;
+            i++;
+        } else {
+            // Report unknown option or bad value
+            std::cerr << "Invalid argument: " << arg << "\n";
+            printUsage(argv[0]);
+            opts.ok = false;
+            return opts;
+        }
+    }
+    // Summing TF-IDF weights needs TF-IDF weights
+    if (opts.scoring == ScorePolicy::TfidfSum)
+        opts.tfidf = true;
+    // Approximate counting only applies to the streaming pipeline
+    if (opts.approxCountsMb > 0 && opts.streamBudgetMb == 0)
+        opts.streamBudgetMb = 64;
+    // Return parsed options
+    return opts;
+}
@@ -0,0 +1,67 @@
+#include "../include/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+// Objective :- Resolve a requested thread count, mapping 0 to the number of hardware threads
+// Input :- requested - desired number of threads (0 means "use all cores")
+// Output :- Returns number of threads to use (at least 1)
+// Sideeffect :- Queries hardware concurrency
+// Assumption :- None
+std::size_t resolveThreads(std::size_t requested) {
+    // Use explicit request when given
+    if (requested > 0)
+        return requested;
+    // Otherwise use all hardware threads (hardware_concurrency may report 0)
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Objective :- Run task(i) for every i in [0, count) on up to 'threads' workers that pull indices from a shared counter
+// Input :- count - number of tasks, threads - number of worker threads (0 means all cores), task - function called with each task index
+// Output :- None (void function)
+// Sideeffect :- Starts and joins worker threads (runs inline when one thread is enough)
+// Assumption :- task is safe to call concurrently for distinct indices and does not throw
+void forEach(std::size_t count, std::size_t threads, const std::function<void(std::size_t)>& task) {
+    // Same scheduling, worker index unused
+    forEachWorker(count, threads, [&](std::size_t i, std::size_t) { task(i); });
+}
+
+// Objective :- Like forEach, but also tell each task which worker runs it, so workers can reuse per-worker scratch space
+// Input :- count - number of tasks, threads - number of worker threads (0 means all cores), task - function called with each task index and the worker index
+// Output :- None (void function)
+// Sideeffect :- Starts and joins worker threads (runs inline when one thread is enough)
+// Assumption :- task is safe to call concurrently for distinct indices and does not throw; worker indices are below resolveThreads(threads) and one worker runs one task at a time
+void forEachWorker(std::size_t count, std::size_t threads, const std::function<void(std::size_t, std::size_t)>& task) {
+    // Never start more workers than there are tasks
+    std::size_t workers = std::min(resolveThreads(threads), count);
+    // Run inline when there is nothing to parallelize
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; i++)
+            task(i, 0);
+        return;
+    }
+
+    // Next task index to hand out
+    std::atomic<std::size_t> next{0};
+    // Worker loop: claim indices until all tasks are taken
+    auto worker = [&](std::size_t w) {
+        for (std::size_t i = next++; i < count; i = next++)
+            task(i, w);
+    };
+
+    // Start helper threads; the calling thread works too as worker 0
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t t = 1; t < workers; t++)
+        pool.emplace_back(worker, t);
+    worker(0);
+    // Wait for all helpers to finish
+    for (auto& th : pool)
+        th.join();
+}
+
+} // namespace parallel
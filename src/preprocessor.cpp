@@ -1,50 +1,71 @@
 #include "../include/preprocessor.h"
-#include <cctype>
-#include <sstream>
+#include "../include/parallel.h"
+#include "../include/simd.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
-// Objective :- Initialize Preprocessor with a set of stopwords for text filtering
-// Input :- None
+// Objective :- Initialize Preprocessor with the stopwords to filter out and the vocabulary tokens are interned into
+// Input :- vocab - vocabulary receiving the token IDs, stopwords - stopword table (built-in English list by default)
 // Output :- None (constructor)
-// Sideeffect :- Calls buildStopwords() to populate stopwords member variable
-// Assumption :- None
-Preprocessor::Preprocessor() : stopwords(buildStopwords()) {} // Initialize stopwords set
-
-// Objective :- Process a single line of text: normalize, tokenize, and remove stopwords
-// Input :- line - string containing raw text line to process
-// Output :- Returns ProcessedLine object containing original line, cleaned text, and filtered tokens
-// Sideeffect :- Creates ProcessedLine object and processes text
-// Assumption :- line is a valid string, may be empty
-ProcessedLine Preprocessor::process(const std::string& line) const {
-    // Create ProcessedLine object to store results
-    ProcessedLine result;
-    // Store original line text
-    result.original = line;
-    // Normalize line (lowercase, remove special chars)
-    result.cleaned = normalize(line);
-    // Tokenize cleaned text into words
-    auto tokens = tokenize(result.cleaned);
-    // Remove stopwords from tokens
-    result.tokens = removeStopWords(tokens);
-    // Return processed line
-    return result;
+// Sideeffect :- Copies the stopword table, stores a reference to vocab
+// Assumption :- vocab outlives the preprocessor
+Preprocessor::Preprocessor(Vocabulary& vocab, const StopwordTable& stopwords)
+    : vocab(vocab),              // Store vocabulary reference
+      stopwords(stopwords) {}    // Store stopword table
+
+// Objective :- Process a single line of text: normalize, tokenize, remove stopwords and intern the remaining tokens
+// Input :- line - view of the raw text line to process (may point into a mapped file)
+// Output :- Returns ProcessedLine object containing original line, cleaned text, and filtered token IDs
+// Sideeffect :- Creates ProcessedLine object and processes text, interns new tokens into the vocabulary
+// Assumption :- line is a valid string, may be empty; not called concurrently (the vocabulary is not thread-safe)
+ProcessedLine Preprocessor::process(std::string_view line) {
+    // Token views reused across calls on this thread
+    thread_local std::vector<std::string_view> views;
+    // Process line against the shared vocabulary
+    return processLine(line, vocab, views);
+}
+
+// Objective :- Process a single line into caller-owned buffers: normalize it and collect its non-stopword tokens as views, without heap allocation once the buffers have grown
+// Input :- line - view of the raw text line, cleaned - string receiving the normalized text, tokens - vector receiving views of the tokens
+// Output :- None (void function)
+// Sideeffect :- Overwrites cleaned, clears tokens and fills it with views into cleaned
+// Assumption :- line does not point into cleaned; the token views are valid until cleaned is next modified
+void Preprocessor::process(std::string_view line, std::string& cleaned, std::vector<std::string_view>& tokens) const {
+    // Normalize line (lowercase, remove special chars) into the reused buffer
+    normalize(line, cleaned);
+    // Start a fresh token list, keeping its capacity
+    tokens.clear();
+    // Scan cleaned text for tokens, skipping stopwords
+    tokenize(cleaned, tokens);
 }
 
 // Objective :- Process all lines in a document, filtering out lines with no tokens after stopword removal
 // Input :- doc - Document object containing lines to process
 // Output :- Returns vector of ProcessedLine objects (only lines with tokens)
-// Sideeffect :- Creates vector and processes each line
-// Assumption :- doc contains valid lines vector, may be empty
-std::vector<ProcessedLine> Preprocessor::process(const Document& doc) const {
+// Sideeffect :- Creates vector and processes each line, interns new tokens into the vocabulary
+// Assumption :- doc contains valid lines vector, may be empty; not called concurrently
+std::vector<ProcessedLine> Preprocessor::process(const Document& doc) {
+    // Process the document's line views
+    return process(doc.lines);
+}
+
+// Objective :- Process a sequence of raw lines, filtering out lines with no tokens after stopword removal
+// Input :- lines - views of the raw text lines to process
+// Output :- Returns vector of ProcessedLine objects (only lines with tokens)
+// Sideeffect :- Creates vector and processes each line, interns new tokens into the vocabulary
+// Assumption :- Views remain valid during the call; not called concurrently
+std::vector<ProcessedLine> Preprocessor::process(const std::vector<std::string_view>& lines) {
     // Initialize vector to store processed lines
     std::vector<ProcessedLine> processed;
     // Reserve space for efficiency
-    processed.reserve(doc.lines.size());
+    processed.reserve(lines.size());
     
-    // Iterate through each line in document
-    for (const auto& line : doc.lines) {
+    // Iterate through each line
+    for (const auto& line : lines) {
         // Process current line
         auto processedLine = process(line);
         // Only add lines that have tokens after processing
@@ -61,124 +82,232 @@ std::vector<ProcessedLine> Preprocessor::process(const Document& doc) const {
 // Objective :- Process all documents and combine their processed lines into a single vector
 // Input :- docs - vector of Document objects to process
 // Output :- Returns vector of ProcessedLine objects from all documents combined
-// Sideeffect :- Creates vector and processes all documents
-// Assumption :- docs vector may be empty, each document is valid
-std::vector<ProcessedLine> Preprocessor::process(const std::vector<Document>& docs) const {
+// Sideeffect :- Creates vector and processes all documents, interns new tokens into the vocabulary
+// Assumption :- docs vector may be empty, each document is valid; not called concurrently
+std::vector<ProcessedLine> Preprocessor::process(const std::vector<Document>& docs) {
     // Initialize vector to store all processed lines
     std::vector<ProcessedLine> all;
     // Iterate through each document
     for (const auto& doc : docs) {
         // Process current document
         auto processed = process(doc);
-        // Append processed lines to combined vector
-        all.insert(all.end(), processed.begin(), processed.end());
+        // Move processed lines to combined vector
+        all.insert(all.end(), std::make_move_iterator(processed.begin()), std::make_move_iterator(processed.end()));
     }
     // Return all processed lines
     return all;
 }
 
-// Objective :- Collect all tokens from all processed lines into a single flat vector
-// Input :- lines - vector of ProcessedLine objects containing tokens
-// Output :- Returns vector of all tokens from all lines
-// Sideeffect :- Creates new vector and copies tokens
-// Assumption :- lines vector may be empty, each ProcessedLine contains valid tokens
-std::vector<std::string> Preprocessor::collectTokens(const std::vector<ProcessedLine>& lines) const {
-    // Initialize vector to store all tokens
-    std::vector<std::string> tokens;
-    // Iterate through each processed line
-    for (const auto& line : lines) {
-        // Append all tokens from current line to token vector
-        tokens.insert(tokens.end(), line.tokens.begin(), line.tokens.end());
+// Number of lines processed by one parallel task (large documents are split into several tasks)
+static const std::size_t kChunkLines = 2048;
+
+// Objective :- Process documents on several threads straight into document arenas, one corpus per document, with the lines (token IDs included) of calling process(doc) for each document in order
+// Input :- docs - documents to process, threads - number of worker threads (0 = all cores)
+// Output :- Returns vector whose element i holds the processed lines of docs[i] (only lines with tokens), one arena per chunk of the document
+// Sideeffect :- Splits documents into chunks processed in parallel against task-local vocabularies, each appended line by line into its own arena through reused buffers,
+//               then interns the chunk vocabularies into the shared vocabulary in document order and rewrites the arenas' token IDs
+// Assumption :- Documents stay valid during the call; not called concurrently
+std::vector<Corpus> Preprocessor::processEach(const std::vector<Document>& docs, std::size_t threads) {
+    // Objective :- One parallel task: a range of lines of one document and its results
+    // Input :- None (data structure)
+    // Output :- None (data structure)
+    // Sideeffect :- None
+    struct Chunk {
+        std::size_t doc{};                       // Index of the document
+        std::size_t begin{}, end{};              // Line range within the document
+        Vocabulary local;                        // Task-local vocabulary the line tokens refer to
+        std::shared_ptr<DocumentArena> arena;    // Processed lines with local token IDs
+    };
+
+    // Split every document into chunks of at most kChunkLines lines
+    std::vector<Chunk> chunks;
+    for (std::size_t d = 0; d < docs.size(); d++)
+        for (std::size_t begin = 0; begin < docs[d].lines.size(); begin += kChunkLines) {
+            chunks.emplace_back();
+            chunks.back().doc = d;
+            chunks.back().begin = begin;
+            chunks.back().end = std::min(begin + kChunkLines, docs[d].lines.size());
+        }
+
+    // Process chunks in parallel; each task touches only its own chunk
+    parallel::forEach(chunks.size(), threads, [&](std::size_t c) {
+        Chunk& chunk = chunks[c];
+        const auto& lines = docs[chunk.doc].lines;
+        // Room for every line of the chunk (original and cleaned text are the same length)
+        std::size_t bytes = 0;
+        for (std::size_t i = chunk.begin; i < chunk.end; i++)
+            bytes += lines[i].size();
+        chunk.arena = std::make_shared<DocumentArena>();
+        chunk.arena->reserve(chunk.end - chunk.begin, 2 * bytes, 0);
+        // Normalize, token and ID buffers reused for every line, so a line costs no allocation of its own
+        std::string cleaned;
+        std::vector<std::string_view> views;
+        std::vector<TokenId> ids;
+        for (std::size_t i = chunk.begin; i < chunk.end; i++) {
+            process(lines[i], cleaned, views);
+            // Only keep lines that have tokens after processing
+            if (views.empty())
+                continue;
+            ids.clear();
+            for (auto token : views)
+                ids.push_back(chunk.local.intern(token));
+            chunk.arena->append(LineView{lines[i], cleaned, TokenSpan{ids.data(), ids.size()}});
+        }
+    });
+
+    // Merge in document order: local IDs are in first-occurrence order, so interning them chunk by chunk
+    // assigns exactly the IDs the serial path would
+    std::vector<Corpus> results(docs.size());
+    std::vector<TokenId> remap;
+    for (auto& chunk : chunks) {
+        // Map local IDs to shared IDs
+        remap.resize(chunk.local.size());
+        for (std::size_t id = 0; id < remap.size(); id++)
+            remap[id] = vocab.intern(chunk.local.text(static_cast<TokenId>(id)));
+        chunk.arena->remapTokens(remap);
+        // The chunk's arena becomes part of its document without copying
+        if (chunk.arena->size() > 0)
+            results[chunk.doc].add(std::move(chunk.arena));
     }
-    // Return collected tokens
-    return tokens;
+    // Return per-document results
+    return results;
 }
 
-// Objective :- Build and return a set of common English stopwords to filter out during text processing
-// Input :- None
-// Output :- Returns unordered_set containing common stopwords
-// Sideeffect :- Creates and returns a set
-// Assumption :- None
-std::unordered_set<std::string> Preprocessor::buildStopwords() {
-    // Return set initialized with common English stopwords
-    return {"a", "an", "the", "and", "or", "but", "if", "then", "else", "for", "with",
-            "about", "into", "onto", "from", "that", "this", "those", "these", "to", "of",
-            "in", "on", "at", "as", "by", "it", "is", "are", "was", "were", "be", "been",
-            "being", "so", "we", "you", "they", "he", "she", "them", "their", "there",
-            "here", "can", "could", "should", "would", "may", "might", "will", "just",
-            "than", "also", "such", "not", "no", "do", "does", "did", "done", "its"};
+// Objective :- Multi-threaded process(docs): process documents across cores and combine their lines in document order
+// Input :- docs - documents to process, threads - number of worker threads (0 = all cores)
+// Output :- Returns vector of ProcessedLine objects from all documents combined, identical to process(docs)
+// Sideeffect :- Runs processEach() and moves its results into one vector
+// Assumption :- Documents stay valid during the call; not called concurrently
+std::vector<ProcessedLine> Preprocessor::process(const std::vector<Document>& docs, std::size_t threads) {
+    // Process documents in parallel
+    auto perDoc = processEach(docs, threads);
+    // Size combined vector once
+    std::size_t total = 0;
+    for (const auto& lines : perDoc)
+        total += lines.size();
+    std::vector<ProcessedLine> all;
+    all.reserve(total);
+    // Copy each document's lines out of its arenas in order
+    for (const auto& lines : perDoc)
+        for (std::size_t i = 0; i < lines.size(); i++) {
+            LineView line = lines.line(i);
+            all.push_back(ProcessedLine{std::string(line.original), std::string(line.cleaned),
+                                        std::vector<TokenId>(line.tokens.begin(), line.tokens.end())});
+        }
+    // Return all processed lines
+    return all;
 }
 
-// Objective :- Normalize text by converting to lowercase and replacing non-alphanumeric characters with spaces
-// Input :- line - string containing text to normalize
-// Output :- Returns normalized string with lowercase letters/numbers and spaces only
-// Sideeffect :- Creates new string
-// Assumption :- line is a valid string, may be empty
-std::string Preprocessor::normalize(const std::string& line) {
-    // Initialize string to store normalized result
-    std::string lower;
-    // Reserve space for efficiency
-    lower.reserve(line.size());
-    
-    // Iterate through each character in input
-    for (unsigned char ch : line) {
-        // Check if character is alphanumeric or whitespace
-        if (std::isalnum(ch) || std::isspace(ch)) {
-            // Convert to lowercase and add to result
-            lower.push_back(std::tolower(ch));
-        } else {
-            // Replace special characters with space
-            lower.push_back(' ');
-        }
+// Objective :- First half of process() that does not touch the vocabulary: copy and normalize each line, leaving tokens empty
+// Input :- lines - views of the raw text lines
+// Output :- Returns one ProcessedLine per input line with original and cleaned text filled in
+// Sideeffect :- Creates vector and copies text
+// Assumption :- Views remain valid during the call; safe to call concurrently
+std::vector<ProcessedLine> Preprocessor::normalizeLines(const std::vector<std::string_view>& lines) const {
+    // One output line per input line
+    std::vector<ProcessedLine> normalized(lines.size());
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        // Copy original line text out of the buffer
+        normalized[i].original.assign(lines[i].data(), lines[i].size());
+        // Normalize line (lowercase, remove special chars)
+        normalize(lines[i], normalized[i].cleaned);
     }
-    
-    // Return normalized string
-    return lower;
+    // Return normalized lines
+    return normalized;
 }
 
-// Objective :- Split text into individual word tokens separated by whitespace
-// Input :- text - string containing text to tokenize
-// Output :- Returns vector of strings, each string is a token (word)
-// Sideeffect :- Creates string stream and vector
-// Assumption :- text is a valid string, may be empty or contain only whitespace
-std::vector<std::string> Preprocessor::tokenize(const std::string& text) {
-    // Create input string stream from text
-    std::istringstream stream(text);
-    // Initialize vector to store tokens
-    std::vector<std::string> tokens;
-    // Variable to hold each token read from stream
-    std::string token;
-    
-    // Extract tokens separated by whitespace
-    while (stream >> token) {
-        // Add token to vector
-        tokens.push_back(token);
-    }
-    
-    // Return vector of tokens
-    return tokens;
+// Objective :- Second half of process(): tokenize the cleaned text of each line, intern its tokens and drop lines without tokens
+// Input :- lines - lines produced by normalizeLines()
+// Output :- None (void function)
+// Sideeffect :- Fills tokens of every line, erases lines with no tokens, interns new tokens into the vocabulary
+// Assumption :- Not called concurrently
+void Preprocessor::internTokens(std::vector<ProcessedLine>& lines) {
+    // Intern into the shared vocabulary
+    internTokens(lines, vocab);
 }
 
-// Objective :- Filter out stopwords from token vector, keeping only meaningful words
-// Input :- tokens - vector of strings containing tokens to filter
-// Output :- Returns vector of tokens with stopwords removed
-// Sideeffect :- Creates new vector
-// Assumption :- tokens vector may be empty, stopwords member variable is initialized
-std::vector<std::string> Preprocessor::removeStopWords(const std::vector<std::string>& tokens) const {
-    // Initialize vector to store filtered tokens
-    std::vector<std::string> filtered;
-    // Reserve space for efficiency
-    filtered.reserve(tokens.size());
-    
-    // Iterate through each token
-    for (const auto& token : tokens) {
-        // Check if token is not a stopword
-        if (stopwords.find(token) == stopwords.end())
-            // Add token to filtered vector
-            filtered.push_back(token);
+// Objective :- internTokens() against a given vocabulary, e.g. a batch-local one that is dropped after the batch so the shared vocabulary does not grow
+// Input :- lines - lines produced by normalizeLines(), target - vocabulary the tokens are interned into
+// Output :- None (void function)
+// Sideeffect :- Fills tokens of every line, erases lines with no tokens, interns new tokens into target
+// Assumption :- target is not used concurrently by another thread
+void Preprocessor::internTokens(std::vector<ProcessedLine>& lines, Vocabulary& target) const {
+    // Token views reused across lines
+    std::vector<std::string_view> views;
+    // Compact kept lines towards the front
+    std::size_t kept = 0;
+    for (auto& line : lines) {
+        // Scan cleaned text for non-stopword tokens
+        views.clear();
+        tokenize(line.cleaned, views);
+        // Drop lines without tokens
+        if (views.empty())
+            continue;
+        // Intern tokens into IDs
+        line.tokens.clear();
+        for (auto token : views)
+            line.tokens.push_back(target.intern(token));
+        // Keep line
+        if (&lines[kept] != &line)
+            lines[kept] = std::move(line);
+        kept++;
     }
-    
-    // Return filtered tokens
-    return filtered;
+    // Remove dropped lines
+    lines.resize(kept);
 }
 
+// Objective :- Normalize text by converting to lowercase and replacing non-alphanumeric characters with spaces (vectorized, see simd::normalizeAscii)
+// Input :- line - view of the text to normalize, out - string receiving the normalized text (its capacity is reused)
+// Output :- None (void function)
+// Sideeffect :- Resizes out to the length of line and overwrites its contents
+// Assumption :- line does not point into out
+void Preprocessor::normalize(std::string_view line, std::string& out) {
+    // Size the output buffer once
+    out.resize(line.size());
+    // Translate all bytes with the widest kernel the CPU supports
+    simd::normalizeAscii(line.data(), line.size(), &out[0]);
+}
+
+// Objective :- Process one line against a given vocabulary (the shared one, or a task-local one in processEach())
+// Input :- line - view of the raw text line, target - vocabulary the tokens are interned into, views - scratch vector for token views
+// Output :- Returns ProcessedLine object with original line, cleaned text and token IDs from target
+// Sideeffect :- Interns new tokens into target, overwrites views
+// Assumption :- target is not used concurrently by another thread
+ProcessedLine Preprocessor::processLine(std::string_view line, Vocabulary& target, std::vector<std::string_view>& views) const {
+    // Create ProcessedLine object to store results
+    ProcessedLine result;
+    // Copy original line text out of the document buffer
+    result.original.assign(line.data(), line.size());
+    // Normalize line and collect its non-stopword tokens
+    process(line, result.cleaned, views);
+    // Intern tokens into IDs
+    result.tokens.reserve(views.size());
+    for (auto token : views)
+        result.tokens.push_back(target.intern(token));
+    // Return processed line
+    return result;
+}
+
+// Objective :- Split normalized text into whitespace-separated tokens in place, dropping stopwords on the fly
+// Input :- text - normalized text to scan, out - vector receiving views of the kept tokens
+// Output :- None (void function)
+// Sideeffect :- Appends views into text to out
+// Assumption :- text is normalized (only lowercase alphanumerics and whitespace remain), stopwords member variable is initialized
+void Preprocessor::tokenize(std::string_view text, std::vector<std::string_view>& out) const {
+    // After normalization every byte up to ' ' is whitespace and every byte above it belongs to a word
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        // Skip separators
+        while (p < end && static_cast<unsigned char>(*p) <= ' ')
+            p++;
+        // Find end of the word
+        const char* word = p;
+        while (p < end && static_cast<unsigned char>(*p) > ' ')
+            p++;
+        // Keep non-empty words that are not stopwords
+        std::string_view token(word, p - word);
+        if (!token.empty() && !stopwords.contains(token))
+            out.push_back(token);
+    }
+}
@@ -1,10 +1,11 @@
 #include "../include/question_generator.h"
+#include "../include/flat_hash_map.h"
 #include <algorithm>
 #include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
 // Objective :- Initialize QuestionGenerator with specified counts for each question type
@@ -22,46 +23,113 @@ QuestionGenerator::QuestionGenerator(std::size_t mcqCount,
       longCount(longCount) {}  // Store long question count
 
 // Objective :- Generate a complete question paper with MCQs, fill-in-blanks, short questions, and long questions from scored lines and keywords
-// Input :- lines - vector of ScoredLine objects (sorted by score), keywords - vector of keyword-frequency pairs
+// Input :- lines - vector of ScoredLine objects (sorted by score), keywords - vector of keyword ID-frequency pairs, vocab - vocabulary used to render keywords as text
 // Output :- Returns QuestionPaper object containing all generated questions
 // Sideeffect :- Creates QuestionPaper object, generates random numbers, may skip questions if generation fails
-// Assumption :- lines and keywords may be empty, lines are sorted by score descending, keywords are sorted by frequency
+// Assumption :- lines and keywords may be empty, lines are sorted by score descending, keywords are sorted by frequency, all IDs are in vocab
 QuestionPaper QuestionGenerator::generate(const std::vector<ScoredLine>& lines,
-                                           const std::vector<std::pair<std::string, std::size_t>>& keywords) const {
+                                           const std::vector<std::pair<TokenId, std::size_t>>& keywords,
+                                           const Vocabulary& vocab) const {
+    // Each keyword is a one-word term
+    std::vector<Term> terms;
+    terms.reserve(keywords.size());
+    for (auto& k : keywords)
+        terms.push_back(Term{{k.first}, vocab.text(k.first)});
+    return generateTerms(lines, terms);
+}
+
+// Objective :- Generate a question paper whose keywords may be multi-word phrases (e.g. from KeyphraseExtractor)
+// Input :- lines - vector of ScoredLine objects (sorted by score), keywords - vector of (keyword or phrase with words separated by spaces, frequency) pairs in rank order, vocab - vocabulary used to map words to token IDs
+// Output :- Returns QuestionPaper object containing all generated questions
+// Sideeffect :- Creates QuestionPaper object, generates random numbers, may skip questions if generation fails
+// Assumption :- lines and keywords may be empty, lines are sorted by score descending; entries with words missing from vocab (e.g. stopwords) are ignored
+QuestionPaper QuestionGenerator::generate(const std::vector<ScoredLine>& lines,
+                                           const std::vector<std::pair<std::string, std::size_t>>& keywords,
+                                           const Vocabulary& vocab) const {
+    std::vector<Term> terms;
+    terms.reserve(keywords.size());
+    for (auto& k : keywords) {
+        // Split the phrase into words and map each to its token ID
+        Term term;
+        std::string_view rest = k.first;
+        bool known = true;
+        while (!rest.empty() && known) {
+            std::size_t space = rest.find(' ');
+            std::string_view word = rest.substr(0, space);
+            rest.remove_prefix(space == std::string_view::npos ? rest.size() : space + 1);
+            if (word.empty())
+                continue;
+            TokenId id = vocab.find(word);
+            known = id != Vocabulary::npos;
+            if (!term.text.empty())
+                term.text += ' ';
+            term.text.append(word.data(), word.size());
+            term.ids.push_back(id);
+        }
+        // Skip entries that can never match a line
+        if (known && !term.ids.empty())
+            terms.push_back(std::move(term));
+    }
+    return generateTerms(lines, terms);
+}
+
+// Objective :- Generate a question paper from compact line references (e.g. LineScorer::scoreTop) instead of line views
+// Input :- corpus - corpus the references index into, lines - scored references sorted by score, keywords - vector of (keyword or phrase, frequency) pairs in rank order, vocab - vocabulary used to map words to token IDs
+// Output :- Returns QuestionPaper object containing all generated questions
+// Sideeffect :- Resolves only the first linesNeeded() references into views, then as generate(lines, keywords, vocab)
+// Assumption :- Every index is below corpus.size(); otherwise as generate(lines, keywords, vocab)
+QuestionPaper QuestionGenerator::generate(const Corpus& corpus,
+                                           const std::vector<ScoredRef>& lines,
+                                           const std::vector<std::pair<std::string, std::size_t>>& keywords,
+                                           const Vocabulary& vocab) const {
+    // Views of the lines the question builders read
+    std::vector<ScoredLine> views;
+    std::size_t needed = std::min(lines.size(), linesNeeded());
+    views.reserve(needed);
+    for (std::size_t i = 0; i < needed; i++)
+        views.push_back(ScoredLine{corpus.line(lines[i].index), lines[i].score});
+    return generate(views, keywords, vocab);
+}
+
+// Objective :- Generate the question paper from keywords already resolved to token ID sequences
+// Input :- lines - vector of ScoredLine objects (sorted by score), terms - keywords and keyphrases in rank order
+// Output :- Returns QuestionPaper object containing all generated questions
+// Sideeffect :- Creates QuestionPaper object, generates random numbers, may skip questions if generation fails
+// Assumption :- lines and terms may be empty, every term has at least one token ID
+QuestionPaper QuestionGenerator::generateTerms(const std::vector<ScoredLine>& lines,
+                                                const std::vector<Term>& terms) const {
     // Initialize empty question paper
     QuestionPaper paper;
     // Return empty paper if inputs are empty
-    if (lines.empty() || keywords.empty())
+    if (lines.empty() || terms.empty())
         return paper;
 
-    // Extract keyword strings from keyword-frequency pairs
-    std::vector<std::string> keywordList;
-    for (auto& k : keywords)
-        keywordList.push_back(k.first);
-
     // Initialize random number generator for shuffling options
     std::mt19937 rng(std::random_device{}());
 
+    // Index the terms once for all MCQs
+    TermIndex index = indexTerms(terms);
+
     // Generate MCQs up to specified count or available lines
     for (size_t i = 0; i < mcqCount && i < lines.size(); i++) {
         try {
             // Build MCQ from scored line
-            paper.mcqs.push_back(buildMcq(lines[i], keywordList, rng));
+            paper.mcqs.push_back(buildMcq(lines[i], terms, index, rng));
         } catch (...) {} // Skip MCQ if generation fails
     }
 
     // Generate fill-in-blank questions up to specified count or available lines
     for (size_t i = 0; i < fillCount && i < lines.size(); i++) {
         // Build fill-in-blank question
-        auto q = buildFillBlank(lines[i], keywordList);
+        auto q = buildFillBlank(lines[i], terms);
         // Add question if not empty
         if (!q.empty())
             paper.fillInBlanks.push_back(q);
     }
 
     // Generate short answer questions from keywords
-    for (size_t i = 0; i < shortCount && i < keywordList.size(); i++)
-        paper.shortQuestions.push_back(buildShortQuestion(keywordList[i]));
+    for (size_t i = 0; i < shortCount && i < terms.size(); i++)
+        paper.shortQuestions.push_back(buildShortQuestion(terms[i].text));
 
     // Generate long answer questions from scored lines
     for (size_t i = 0; i < longCount && i < lines.size(); i++)
@@ -71,60 +139,111 @@ QuestionPaper QuestionGenerator::generate(const std::vector<ScoredLine>& lines,
     return paper;
 }
 
+// Objective :- Report how many of the best-scoring lines generate() can use
+// Input :- None
+// Output :- Returns the largest of the MCQ, fill-in-blank and long question counts
+// Sideeffect :- None
+// Assumption :- None
+std::size_t QuestionGenerator::linesNeeded() const {
+    // Only the first lines are ever read by the line-based question builders
+    return std::max({mcqCount, fillCount, longCount});
+}
+
+// Objective :- Index terms by their first token ID and by their number of words
+// Input :- terms - keywords and keyphrases in rank order
+// Output :- Returns the index
+// Sideeffect :- Allocates one list entry per term in each lookup
+// Assumption :- Every term has at least one token ID
+QuestionGenerator::TermIndex QuestionGenerator::indexTerms(const std::vector<Term>& terms) {
+    TermIndex index;
+    index.byFirst.reserve(terms.size());
+    for (std::size_t k = 0; k < terms.size(); k++) {
+        // Each list stays in rank order
+        index.byFirst[terms[k].ids[0]].push_back(k);
+        if (index.byLength.size() <= terms[k].ids.size())
+            index.byLength.resize(terms[k].ids.size() + 1);
+        index.byLength[terms[k].ids.size()].push_back(k);
+    }
+    return index;
+}
+
 // Objective :- Build a multiple choice question from a scored line by finding a keyword and creating options with distractors
-// Input :- line - ScoredLine object containing processed line, keywords - vector of keyword strings, rng - random number generator reference
+// Input :- line - ScoredLine object containing processed line, keywords - keywords and keyphrases in rank order, index - indexTerms(keywords), rng - random number generator reference
 // Output :- Returns MCQ object with prompt, options, and correct answer
-// Sideeffect :- Shuffles distractors and options, throws exception if keyword not found or insufficient distractors
+// Sideeffect :- Draws 3 distractors without replacement (O(1) per draw), shuffles options, throws exception if keyword not found or insufficient distractors
 // Assumption :- line contains tokens, keywords vector has at least 4 entries, rng is initialized
 MCQ QuestionGenerator::buildMcq(const ScoredLine& line,
-                                 const std::vector<std::string>& keywords,
+                                 const std::vector<Term>& keywords,
+                                 const TermIndex& index,
                                  std::mt19937& rng) {
-    // Create set of keywords for fast lookup
-    std::unordered_set<std::string> kw(keywords.begin(), keywords.end());
-    // Variable to store found keyword
-    std::string keyword;
-
-    // Find first keyword that appears in line tokens
-    for (auto& t : line.line.tokens)
-        if (kw.count(t)) {
-            keyword = t;
-            break;
+    // Index of found keyword
+    std::size_t keyword = keywords.size();
+
+    // Find the keyword starting earliest in the line (the best-ranked one if several start at the same token)
+    const TokenSpan& tokens = line.line.tokens;
+    for (std::size_t p = 0; p < tokens.size() && keyword == keywords.size(); p++) {
+        const std::vector<std::size_t>* starting = index.byFirst.find(tokens[p]);
+        if (!starting)
+            continue;
+        for (std::size_t k : *starting) {
+            const auto& ids = keywords[k].ids;
+            if (p + ids.size() <= tokens.size() && std::equal(ids.begin(), ids.end(), tokens.begin() + p)) {
+                keyword = k;
+                break;
+            }
         }
+    }
 
     // Throw exception if no keyword found in line
-    if (keyword.empty())
+    if (keyword == keywords.size())
         throw std::runtime_error("No keyword found");
 
-    // Collect distractors (keywords other than the correct one)
-    std::vector<std::string> distractors;
-    for (auto& k : keywords)
-        if (k != keyword)
-            distractors.push_back(k);
+    // Distractors come from the keywords other than the correct one, preferring ones with as many words as the answer
+    const std::vector<std::size_t>& sameLength = index.byLength[keywords[keyword].ids.size()];
+    const bool preferSame = sameLength.size() - 1 >= 3;
+    const std::size_t pool = preferSame ? sameLength.size() - 1 : keywords.size() - 1;
 
     // Throw exception if not enough distractors for 4 options
-    if (distractors.size() < 3)
+    if (pool < 3)
         throw std::runtime_error("Not enough distractors");
 
-    // Shuffle distractors for randomness
-    std::shuffle(distractors.begin(), distractors.end(), rng);
-    // Create options list with correct answer and 3 distractors
-    std::vector<std::string> options = {
-        keyword, distractors[0], distractors[1], distractors[2]
-    };
+    // Mask the answer in the statement; throw exception if it cannot be located in the text
+    const std::string& answerText = keywords[keyword].text;
+    std::string statement = maskKeyword(line.line, answerText);
+    if (statement.empty())
+        throw std::runtime_error("Keyword not found in text");
+
+    // Position of the answer in its candidate list, skipped when drawing
+    std::size_t answerAt = keyword;
+    if (preferSame)
+        answerAt = std::lower_bound(sameLength.begin(), sameLength.end(), keyword) - sameLength.begin();
+
+    // Draw 3 distinct distractors uniformly without replacement (Floyd's algorithm: one draw each, no pass over the pool); the options are shuffled below,
+    // so the paper has the same distribution as shuffling every candidate and taking the first three
+    std::size_t picked[3];
+    for (std::size_t d = 0, j = pool - 3; d < 3; d++, j++) {
+        std::size_t t = std::uniform_int_distribution<std::size_t>(0, j)(rng);
+        picked[d] = std::find(picked, picked + d, t) != picked + d ? j : t;
+    }
+    // Create options list with correct answer and 3 distractors (pool positions at or after the answer's are shifted past it)
+    std::vector<std::string> options{answerText};
+    for (std::size_t t : picked) {
+        std::size_t at = t < answerAt ? t : t + 1;
+        options.push_back(keywords[preferSame ? sameLength[at] : at].text);
+    }
     // Shuffle options so correct answer is in random position
     std::shuffle(options.begin(), options.end(), rng);
 
     // Find correct answer label (A, B, C, or D)
     char answer = 'A';
     for (size_t i = 0; i < options.size(); i++)
-        if (options[i] == keyword)
+        if (options[i] == answerText)
             answer = char('A' + i);
 
     // Create MCQ object
     MCQ mcq;
     // Build prompt with masked keyword
-    mcq.prompt = "Identify the keyword that completes the statement:\n    " +
-                 maskKeyword(line.line.original, keyword);
+    mcq.prompt = "Identify the keyword that completes the statement:\n    " + statement;
     // Set shuffled options
     mcq.options = options;
     // Set correct answer label
@@ -135,17 +254,20 @@ MCQ QuestionGenerator::buildMcq(const ScoredLine& line,
 }
 
 // Objective :- Build a fill-in-the-blank question by finding a keyword in the line and masking it
-// Input :- line - ScoredLine object containing processed line, keywords - vector of keyword strings to search for
+// Input :- line - ScoredLine object containing processed line, keywords - keywords and keyphrases to search for, in rank order
 // Output :- Returns string containing question with masked keyword, or empty string if no keyword found
 // Sideeffect :- None
 // Assumption :- line contains valid tokens, keywords vector may be empty
 std::string QuestionGenerator::buildFillBlank(const ScoredLine& line,
-                                               const std::vector<std::string>& keywords) {
-    // Search for first keyword that appears in line
-    for (auto& k : keywords)
-        if (containsKeyword(line.line, k))
+                                               const std::vector<Term>& keywords) {
+    // Search for first keyword that appears in line and can be located in its text
+    for (const auto& k : keywords)
+        if (containsKeyword(line.line, k.ids)) {
             // Return line with keyword masked
-            return maskKeyword(line.line.original, k);
+            std::string masked = maskKeyword(line.line, k.text);
+            if (!masked.empty())
+                return masked;
+        }
     // Return empty string if no keyword found
     return {};
 }
@@ -164,7 +286,7 @@ std::string QuestionGenerator::buildShortQuestion(const std::string& keyword) {
 // Input :- line - ScoredLine object containing original line text
 // Output :- Returns formatted long question string
 // Sideeffect :- Creates string stream
-// Assumption :- line.line.original contains valid text
+// Assumption :- line.line.original views valid text
 std::string QuestionGenerator::buildLongQuestion(const ScoredLine& line) {
     // Create output string stream
     std::ostringstream ss;
@@ -175,48 +297,54 @@ std::string QuestionGenerator::buildLongQuestion(const ScoredLine& line) {
     return ss.str();
 }
 
-// Objective :- Check if a processed line contains a specific keyword in its tokens
-// Input :- line - ProcessedLine object containing tokens, kw - string keyword to search for
+// Objective :- Check if a processed line contains a keyword or keyphrase as consecutive tokens
+// Input :- line - view of a processed line containing token IDs, kw - token IDs of the keyword to search for
 // Output :- Returns true if keyword found in tokens, false otherwise
 // Sideeffect :- None
-// Assumption :- line.tokens vector is valid, kw is a valid string
-bool QuestionGenerator::containsKeyword(const ProcessedLine& line, const std::string& kw) {
-    // Search for keyword in tokens vector
-    return std::find(line.tokens.begin(), line.tokens.end(), kw) != line.tokens.end();
+// Assumption :- line views valid storage
+bool QuestionGenerator::containsKeyword(const LineView& line, const std::vector<TokenId>& kw) {
+    // Search for the ID sequence in the tokens
+    return std::search(line.tokens.begin(), line.tokens.end(), kw.begin(), kw.end()) != line.tokens.end();
 }
 
-// Objective :- Remove (mask) a keyword from text by finding it case-insensitively and deleting it
-// Input :- text - string containing original text, keyword - string keyword to remove
-// Output :- Returns text string with keyword removed, or original text if keyword not found
-// Sideeffect :- Creates lowercase copies of strings
-// Assumption :- text and keyword are valid strings, keyword may appear in text
-std::string QuestionGenerator::maskKeyword(const std::string& text, const std::string& keyword) {
-    // Lambda function to convert string to lowercase
-    auto lower = [](const std::string& s) {
-        std::string out;
-        // Convert each character to lowercase
-        for (unsigned char c : s)
-            out.push_back(std::tolower(c));
-        return out;
-    };
-
-    // Convert text and keyword to lowercase for case-insensitive search
-    std::string lowText = lower(text);
-    std::string lowKey = lower(keyword);
-    // Find keyword position in lowercase text
-    size_t pos = lowText.find(lowKey);
-
-    // Check if keyword was found
-    if (pos != std::string::npos) {
-        // Create copy of original text
-        std::string masked = text;
-        // Replace keyword with empty string (remove it)
-        masked.replace(pos, keyword.size(), "");
-        // Return masked text
-        return masked;
+// Objective :- Remove (mask) a keyword or keyphrase from the original text, locating it case-insensitively through the cleaned text
+// Input :- line - view of the processed line (cleaned text is aligned byte for byte with the original), keyword - words separated by single spaces
+// Output :- Returns original text with keyword removed, or empty string if keyword not found
+// Sideeffect :- Creates a copy of the original text
+// Assumption :- keyword is lowercase alphanumeric words; in the text the words may be separated by any run of whitespace or punctuation
+std::string QuestionGenerator::maskKeyword(const LineView& line, const std::string& keyword) {
+    // Cleaned text is the lowercased original with punctuation turned into spaces
+    std::string_view text = line.cleaned;
+    std::string_view key = keyword;
+    std::size_t firstEnd = std::min(key.find(' '), key.size());
+    std::string_view firstWord = key.substr(0, firstEnd);
+
+    // Try each occurrence of the first word
+    for (std::size_t pos = text.find(firstWord); pos != std::string_view::npos; pos = text.find(firstWord, pos + 1)) {
+        // Match the remaining words, allowing any run of separators between them
+        std::size_t t = pos + firstWord.size();
+        std::size_t k = firstEnd;
+        bool match = true;
+        while (k < key.size() && match) {
+            // Skip the single space in the keyword and at least one separator in the text
+            k++;
+            std::size_t gap = t;
+            while (t < text.size() && static_cast<unsigned char>(text[t]) <= ' ')
+                t++;
+            std::size_t wordEnd = std::min(key.find(' ', k), key.size());
+            std::string_view word = key.substr(k, wordEnd - k);
+            match = t > gap && text.compare(t, word.size(), word) == 0;
+            t += word.size();
+            k = wordEnd;
+        }
+        if (match) {
+            // Remove the matched range from the original text (same offsets as the cleaned text)
+            std::string masked(line.original);
+            masked.erase(pos, t - pos);
+            return masked;
+        }
     }
 
-    // Return original text if keyword not found
-    return text;
+    // Return empty string if keyword not found
+    return {};
 }
-
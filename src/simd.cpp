@@ -0,0 +1,282 @@
+#include "../include/simd.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define QPG_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+// Objective :- Build the byte translation table used by the scalar normalization path
+// Input :- None
+// Output :- Returns 256-entry table mapping each byte to its normalized value
+// Sideeffect :- None
+// Assumption :- Matches the "C" locale: alphanumerics are [0-9A-Za-z], whitespace is space and \t \n \v \f \r
+struct NormalizeTable {
+    char map[256];
+    constexpr NormalizeTable() : map() {
+        for (int c = 0; c < 256; c++) {
+            if (c >= 'A' && c <= 'Z')
+                map[c] = static_cast<char>(c + ('a' - 'A'));
+            else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == ' ' || (c >= '\t' && c <= '\r'))
+                map[c] = static_cast<char>(c);
+            else
+                map[c] = ' ';
+        }
+    }
+};
+static constexpr NormalizeTable kNormalize{};
+
+// Objective :- Scalar normalization using the translation table
+// Input :- in - source bytes, n - number of bytes, out - destination with room for n bytes
+// Output :- None (void function)
+// Sideeffect :- Writes n bytes to out
+// Assumption :- None
+static void normalizeScalar(const char* in, std::size_t n, char* out) {
+    for (std::size_t i = 0; i < n; i++)
+        out[i] = kNormalize.map[static_cast<unsigned char>(in[i])];
+}
+
+#ifdef QPG_X86_KERNELS
+// Objective :- SSE2 normalization of 16 bytes per step, scalar tail
+// Input :- in - source bytes, n - number of bytes, out - destination with room for n bytes
+// Output :- None (void function)
+// Sideeffect :- Writes n bytes to out
+// Assumption :- CPU supports SSE2
+__attribute__((target("sse2")))
+static void normalizeSse2(const char* in, std::size_t n, char* out) {
+    // Range bounds as signed bytes; bytes >= 0x80 are negative and fall outside every range
+    const __m128i upperLo = _mm_set1_epi8('A' - 1), upperHi = _mm_set1_epi8('Z' + 1);
+    const __m128i lowerLo = _mm_set1_epi8('a' - 1), lowerHi = _mm_set1_epi8('z' + 1);
+    const __m128i digitLo = _mm_set1_epi8('0' - 1), digitHi = _mm_set1_epi8('9' + 1);
+    const __m128i ctrlLo = _mm_set1_epi8('\t' - 1), ctrlHi = _mm_set1_epi8('\r' + 1);
+    const __m128i space = _mm_set1_epi8(' '), caseBit = _mm_set1_epi8(0x20);
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Classify each byte
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, upperLo), _mm_cmplt_epi8(v, upperHi));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, lowerLo), _mm_cmplt_epi8(v, lowerHi));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, digitLo), _mm_cmplt_epi8(v, digitHi));
+        __m128i ctrl = _mm_and_si128(_mm_cmpgt_epi8(v, ctrlLo), _mm_cmplt_epi8(v, ctrlHi));
+        __m128i keep = _mm_or_si128(_mm_or_si128(upper, lower),
+                                    _mm_or_si128(_mm_or_si128(digit, ctrl), _mm_cmpeq_epi8(v, space)));
+        // Lowercase letters, replace everything else that is not kept with a space
+        __m128i lowered = _mm_or_si128(v, _mm_and_si128(upper, caseBit));
+        __m128i result = _mm_or_si128(_mm_and_si128(keep, lowered), _mm_andnot_si128(keep, space));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+    }
+    // Remaining bytes
+    normalizeScalar(in + i, n - i, out + i);
+}
+
+// Objective :- AVX2 normalization of 32 bytes per step, SSE2/scalar tail
+// Input :- in - source bytes, n - number of bytes, out - destination with room for n bytes
+// Output :- None (void function)
+// Sideeffect :- Writes n bytes to out
+// Assumption :- CPU supports AVX2
+__attribute__((target("avx2")))
+static void normalizeAvx2(const char* in, std::size_t n, char* out) {
+    // Range bounds as signed bytes; bytes >= 0x80 are negative and fall outside every range
+    const __m256i upperLo = _mm256_set1_epi8('A' - 1), upperHi = _mm256_set1_epi8('Z' + 1);
+    const __m256i lowerLo = _mm256_set1_epi8('a' - 1), lowerHi = _mm256_set1_epi8('z' + 1);
+    const __m256i digitLo = _mm256_set1_epi8('0' - 1), digitHi = _mm256_set1_epi8('9' + 1);
+    const __m256i ctrlLo = _mm256_set1_epi8('\t' - 1), ctrlHi = _mm256_set1_epi8('\r' + 1);
+    const __m256i space = _mm256_set1_epi8(' '), caseBit = _mm256_set1_epi8(0x20);
+
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        // Classify each byte (x < hi is expressed as hi > x)
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, upperLo), _mm256_cmpgt_epi8(upperHi, v));
+        __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, lowerLo), _mm256_cmpgt_epi8(lowerHi, v));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, digitLo), _mm256_cmpgt_epi8(digitHi, v));
+        __m256i ctrl = _mm256_and_si256(_mm256_cmpgt_epi8(v, ctrlLo), _mm256_cmpgt_epi8(ctrlHi, v));
+        __m256i keep = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                       _mm256_or_si256(_mm256_or_si256(digit, ctrl), _mm256_cmpeq_epi8(v, space)));
+        // Lowercase letters, replace everything else that is not kept with a space
+        __m256i lowered = _mm256_or_si256(v, _mm256_and_si256(upper, caseBit));
+        __m256i result = _mm256_blendv_epi8(space, lowered, keep);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+    }
+    // Remaining bytes
+    normalizeSse2(in + i, n - i, out + i);
+}
+#endif
+
+// Objective :- Report whether the running CPU supports AVX2
+// Input :- None
+// Output :- Returns true if AVX2 kernels can be used
+// Sideeffect :- Queries CPU features on first call
+// Assumption :- None
+bool hasAvx2() {
+#ifdef QPG_X86_KERNELS
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+#ifdef QPG_X86_KERNELS
+// Objective :- Report whether the running CPU supports SSE2
+// Input :- None
+// Output :- Returns true if SSE2 kernels can be used
+// Sideeffect :- Queries CPU features on first call
+// Assumption :- None
+static bool hasSse2() {
+    static const bool supported = __builtin_cpu_supports("sse2");
+    return supported;
+}
+#endif
+
+// Objective :- Report whether a kernel family can run on this build and CPU
+// Input :- kernel - kernel family
+// Output :- Returns true if the kernel is compiled in and the CPU supports it
+// Sideeffect :- Queries CPU features on first call
+// Assumption :- None
+bool supports(Kernel kernel) {
+    switch (kernel) {
+#ifdef QPG_X86_KERNELS
+    case Kernel::Sse2:
+        return hasSse2();
+    case Kernel::Avx2:
+        return hasAvx2();
+#endif
+    case Kernel::Scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Objective :- Lowercase ASCII letters and map every byte that is neither alphanumeric nor whitespace to a space, 16-32 bytes at a time
+// Input :- in - source bytes, n - number of bytes, out - destination with room for n bytes
+// Output :- None (void function)
+// Sideeffect :- Writes n bytes to out
+// Assumption :- in and out do not overlap partially (in == out is allowed)
+void normalizeAscii(const char* in, std::size_t n, char* out) {
+    // Pick the widest kernel once
+    using Kernel = void (*)(const char*, std::size_t, char*);
+    static const Kernel kernel =
+#ifdef QPG_X86_KERNELS
+        hasAvx2() ? normalizeAvx2 : hasSse2() ? normalizeSse2 :
+#endif
+        normalizeScalar;
+    kernel(in, n, out);
+}
+
+// Objective :- normalizeAscii() with a chosen kernel instead of the widest one the CPU supports
+// Input :- kernel - kernel family, in - source bytes, n - number of bytes, out - destination with room for n bytes
+// Output :- None (void function)
+// Sideeffect :- Writes n bytes to out
+// Assumption :- supports(kernel); in and out do not overlap partially
+void normalizeAscii(Kernel kernel, const char* in, std::size_t n, char* out) {
+    switch (kernel) {
+#ifdef QPG_X86_KERNELS
+    case Kernel::Sse2:
+        normalizeSse2(in, n, out);
+        return;
+    case Kernel::Avx2:
+        normalizeAvx2(in, n, out);
+        return;
+#endif
+    default:
+        normalizeScalar(in, n, out);
+        return;
+    }
+}
+
+// Objective :- Scalar per-line sums of token weights
+// Input :- weights - weight table of limit + 1 entries, limit - index of the sentinel entry, ids - token column, offsets - line starts (lines + 1 entries), lines - number of lines, sums - output
+// Output :- None (void function)
+// Sideeffect :- Writes one sum per line
+// Assumption :- weights[limit] == 0; offsets are non-decreasing
+static void lineSumsScalar(const float* weights, std::uint32_t limit, const std::uint32_t* ids,
+                           const std::uint32_t* offsets, std::size_t lines, float* sums) {
+    for (std::size_t l = 0; l < lines; l++) {
+        float sum = 0.0f;
+        for (std::uint32_t i = offsets[l]; i < offsets[l + 1]; i++)
+            sum += weights[std::min(ids[i], limit)];
+        sums[l] = sum;
+    }
+}
+
+#ifdef QPG_X86_KERNELS
+// Objective :- AVX2 per-line sums of token weights: 8 IDs per gather, then one masked load and masked gather for the line's last 1-7 IDs, so no line needs a scalar tail
+// Input :- weights - weight table of limit + 1 entries, limit - index of the sentinel entry, ids - token column, offsets - line starts (lines + 1 entries), lines - number of lines, sums - output
+// Output :- None (void function)
+// Sideeffect :- Writes one sum per line
+// Assumption :- CPU supports AVX2; weights[limit] == 0; limit < 2^31; offsets are non-decreasing
+__attribute__((target("avx2")))
+static void lineSumsAvx2(const float* weights, std::uint32_t limit, const std::uint32_t* ids,
+                         const std::uint32_t* offsets, std::size_t lines, float* sums) {
+    const __m256i last = _mm256_set1_epi32(static_cast<int>(limit));
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (std::size_t l = 0; l < lines; l++) {
+        const std::uint32_t end = offsets[l + 1];
+        std::uint32_t i = offsets[l];
+        __m256 acc = _mm256_setzero_ps();
+        // Full groups of 8 IDs: clamp unknown IDs to the sentinel, gather their weights
+        for (; i + 8 <= end; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids + i));
+            v = _mm256_min_epu32(v, last);
+            acc = _mm256_add_ps(acc, _mm256_i32gather_ps(weights, v, 4));
+        }
+        // Tail: masked-off lanes are neither loaded nor gathered and contribute 0
+        if (i < end) {
+            __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(end - i)), lane);
+            __m256i v = _mm256_maskload_epi32(reinterpret_cast<const int*>(ids + i), mask);
+            v = _mm256_min_epu32(v, last);
+            acc = _mm256_add_ps(acc, _mm256_mask_i32gather_ps(_mm256_setzero_ps(), weights, v,
+                                                              _mm256_castsi256_ps(mask), 4));
+        }
+        // Horizontal sum of the 8 lanes
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        sums[l] = _mm_cvtss_f32(s);
+    }
+}
+#endif
+
+// Objective :- Sum the token weights of each line in a block of lines stored back to back (8 IDs per gather with AVX2, a masked gather for each line's tail), clamping IDs past the table to its zero sentinel
+// Input :- weights - weight table of limit + 1 entries, limit - index of the sentinel entry, ids - token column, offsets - start of each line's tokens in ids (lines + 1 entries, the last one marks the end), lines - number of lines, sums - output, one entry per line
+// Output :- None (void function)
+// Sideeffect :- Writes sums[l] = sum of weights[min(ids[i], limit)] over line l's tokens, in single precision (summation order differs between kernels, so results agree within float rounding)
+// Assumption :- weights[limit] == 0; limit < 2^31 (the AVX2 gather uses signed 32-bit indices); offsets are non-decreasing
+void lineSums(const float* weights, std::uint32_t limit, const std::uint32_t* ids,
+              const std::uint32_t* offsets, std::size_t lines, float* sums) {
+    // Pick the widest kernel once
+    using Kernel = void (*)(const float*, std::uint32_t, const std::uint32_t*, const std::uint32_t*, std::size_t, float*);
+    static const Kernel kernel =
+#ifdef QPG_X86_KERNELS
+        hasAvx2() ? lineSumsAvx2 :
+#endif
+        lineSumsScalar;
+    kernel(weights, limit, ids, offsets, lines, sums);
+}
+
+// Objective :- lineSums() with a chosen kernel instead of the widest one the CPU supports (SSE2 has no gather and runs the scalar loop)
+// Input :- kernel - kernel family; the rest as lineSums()
+// Output :- None (void function)
+// Sideeffect :- Writes one sum per line
+// Assumption :- supports(kernel); as lineSums()
+void lineSums(Kernel kernel, const float* weights, std::uint32_t limit, const std::uint32_t* ids,
+              const std::uint32_t* offsets, std::size_t lines, float* sums) {
+#ifdef QPG_X86_KERNELS
+    if (kernel == Kernel::Avx2) {
+        lineSumsAvx2(weights, limit, ids, offsets, lines, sums);
+        return;
+    }
+#else
+    (void)kernel;
+#endif
+    lineSumsScalar(weights, limit, ids, offsets, lines, sums);
+}
+
+} // namespace simd
@@ -0,0 +1,283 @@
+#include "../include/stopword_table.h"
+#include "../include/file_buffer.h"
+#include "../include/simd.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Built-in English stopwords
+static constexpr std::string_view kBuiltIn[] = {
+    "a", "an", "the", "and", "or", "but", "if", "then", "else", "for", "with",
+    "about", "into", "onto", "from", "that", "this", "those", "these", "to", "of",
+    "in", "on", "at", "as", "by", "it", "is", "are", "was", "were", "be", "been",
+    "being", "so", "we", "you", "they", "he", "she", "them", "their", "there",
+    "here", "can", "could", "should", "would", "may", "might", "will", "just",
+    "than", "also", "such", "not", "no", "do", "does", "did", "done", "its"};
+static constexpr std::size_t kBuiltInCount = sizeof(kBuiltIn) / sizeof(kBuiltIn[0]);
+
+// Size of the compile-time table (power of two, sparse enough for a seed to be found quickly)
+static constexpr std::size_t kBuiltInSlots = 512;
+
+// Most times build() doubles the runtime table before giving up (distinct hashes are always placed long before)
+static const int kMaxDoublings = 8;
+
+// Objective :- Compute the 64-bit FNV-1a hash of a token
+// Input :- text - token bytes
+// Output :- Returns the hash value
+// Sideeffect :- None
+// Assumption :- None
+static constexpr std::uint64_t hashToken(std::string_view text) {
+    // FNV-1a offset basis
+    std::uint64_t hash = 1469598103934665603ULL;
+    // Mix in each byte
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Objective :- Scramble a token hash with a seed so different seeds give independent slot choices
+// Input :- hash - token hash, seed - seed of the table or bucket
+// Output :- Returns the mixed 64-bit value (murmur3 finalizer)
+// Sideeffect :- None
+// Assumption :- None
+static constexpr std::uint64_t mixSeed(std::uint64_t hash, std::uint64_t seed) {
+    std::uint64_t x = hash ^ (seed * 0x9E3779B97F4A7C15ULL);
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Objective :- Compile-time perfect-hash table over the built-in stopwords: one seed that maps every word to its own slot
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+// Assumption :- kBuiltIn has no duplicates and fewer than 256 entries
+struct BuiltInTable {
+    std::uint64_t seed = 0;                  // Seed placing every word in a distinct slot (0 if none was found)
+    std::uint8_t slots[kBuiltInSlots] = {};  // Word index + 1 per slot, 0 for empty slots
+
+    // Objective :- Search seeds until one is collision-free and fill the table with it
+    // Input :- None
+    // Output :- None (constructor)
+    // Sideeffect :- Sets seed and slots
+    // Assumption :- Evaluated at compile time
+    constexpr BuiltInTable() {
+        for (std::uint64_t candidate = 1; candidate < 100000; candidate++) {
+            // Try to place every word
+            std::uint8_t trial[kBuiltInSlots] = {};
+            bool ok = true;
+            for (std::size_t i = 0; i < kBuiltInCount && ok; i++) {
+                std::size_t slot = mixSeed(hashToken(kBuiltIn[i]), candidate) & (kBuiltInSlots - 1);
+                if (trial[slot] != 0)
+                    ok = false;
+                else
+                    trial[slot] = static_cast<std::uint8_t>(i + 1);
+            }
+            // Keep the first seed without collisions
+            if (ok) {
+                seed = candidate;
+                for (std::size_t s = 0; s < kBuiltInSlots; s++)
+                    slots[s] = trial[s];
+                return;
+            }
+        }
+    }
+};
+static constexpr BuiltInTable kBuiltInTable{};
+static_assert(kBuiltInCount < 256, "built-in stopword indices must fit in one byte");
+static_assert(kBuiltInTable.seed != 0, "no perfect hash seed found for the built-in stopwords");
+
+// Objective :- Check whether a token is one of the built-in stopwords using the compile-time table
+// Input :- token - normalized token
+// Output :- Returns true if token is a built-in stopword
+// Sideeffect :- None
+// Assumption :- None
+bool StopwordTable::isBuiltIn(std::string_view token) {
+    // One probe, then confirm with a single compare
+    std::uint8_t index = kBuiltInTable.slots[mixSeed(hashToken(token), kBuiltInTable.seed) & (kBuiltInSlots - 1)];
+    return index != 0 && kBuiltIn[index - 1] == token;
+}
+
+// Objective :- Add the words of a stopword file to the table and rebuild the perfect hash over built-in and custom words
+// Input :- path - path to a text file with stopwords separated by whitespace; lines starting with '#' are comments
+// Output :- Returns true on success, false if the file cannot be read or its words cannot be compiled into a table (the table is then left as it was)
+// Sideeffect :- Reads the file, rebuilds the runtime table, writes error message to cerr on failure
+// Assumption :- Words are normalized like document text (lowercased, other punctuation splits words), so they match the tokens they are meant to remove
+bool StopwordTable::loadFile(const std::string& path) {
+    // Read the whole file
+    auto buffer = FileBuffer::read(path);
+    if (!buffer) {
+        std::cerr << "[StopwordTable] Cannot read stopword file: " << path << "\n";
+        return false;
+    }
+
+    // Start from the current words (the built-in list on first load)
+    std::vector<std::string> all = words;
+    if (all.empty())
+        all.assign(std::begin(kBuiltIn), std::end(kBuiltIn));
+
+    // Walk the file line by line
+    std::string_view text = buffer->view();
+    std::string cleaned;
+    while (!text.empty()) {
+        std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        // Skip comment lines
+        if (!line.empty() && line[0] == '#')
+            continue;
+        // Normalize the same way document lines are normalized
+        cleaned.resize(line.size());
+        simd::normalizeAscii(line.data(), line.size(), &cleaned[0]);
+        // Split on whitespace
+        const char* p = cleaned.data();
+        const char* stop = p + cleaned.size();
+        while (p < stop) {
+            while (p < stop && static_cast<unsigned char>(*p) <= ' ')
+                p++;
+            const char* word = p;
+            while (p < stop && static_cast<unsigned char>(*p) > ' ')
+                p++;
+            if (p > word)
+                all.emplace_back(word, p - word);
+        }
+    }
+
+    // Deduplicate (a perfect hash cannot separate identical keys)
+    std::sort(all.begin(), all.end());
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+    std::vector<std::string> previous = std::move(words);
+    words = std::move(all);
+    // Compile the runtime table, keeping the previous one if it cannot be built
+    if (!build()) {
+        std::cerr << "[StopwordTable] Cannot build a stopword table from: " << path << "\n";
+        words = std::move(previous);
+        if (words.empty() || !build()) {
+            words.clear();
+            seeds.clear();
+            slots.clear();
+            slotMask = 0;
+        }
+        return false;
+    }
+    return true;
+}
+
+// Objective :- Check whether a token is a stopword
+// Input :- token - normalized token (lowercase alphanumerics)
+// Output :- Returns true if token is in the table
+// Sideeffect :- None
+// Assumption :- None
+bool StopwordTable::contains(std::string_view token) const {
+    // No file loaded: use the compile-time table
+    if (slots.empty())
+        return isBuiltIn(token);
+    // Bucket selects the seed, the seed selects the slot
+    std::uint64_t hash = hashToken(token);
+    std::uint32_t seed = seeds[(hash >> 32) % seeds.size()];
+    std::uint32_t index = slots[mixSeed(hash, seed) & slotMask];
+    // Confirm with a single compare
+    return index != 0 && words[index - 1] == token;
+}
+
+// Objective :- Report the number of stopwords in the table
+// Input :- None
+// Output :- Returns the number of distinct stopwords
+// Sideeffect :- None
+// Assumption :- None
+std::size_t StopwordTable::size() const {
+    return words.empty() ? kBuiltInCount : words.size();
+}
+
+// Objective :- Compile the words into a perfect-hash table, growing the table until every bucket finds a seed
+// Input :- None
+// Output :- Returns true on success, false if two words share a 64-bit hash (no seed can separate them) or the table stops fitting after kMaxDoublings doublings
+// Sideeffect :- Fills seeds, slots and slotMask (left partly filled on failure), writes the colliding words to cerr
+// Assumption :- words is non-empty, sorted and free of duplicates
+bool StopwordTable::build() {
+    // Hash every word once
+    std::vector<std::uint64_t> hashes(words.size());
+    for (std::size_t i = 0; i < words.size(); i++)
+        hashes[i] = hashToken(words[i]);
+
+    // Words with equal hashes land in the same slot under every seed
+    std::vector<std::uint32_t> byHash(words.size());
+    for (std::size_t i = 0; i < words.size(); i++)
+        byHash[i] = static_cast<std::uint32_t>(i);
+    std::sort(byHash.begin(), byHash.end(), [&](std::uint32_t a, std::uint32_t b) { return hashes[a] < hashes[b]; });
+    for (std::size_t i = 1; i < byHash.size(); i++) {
+        if (hashes[byHash[i]] == hashes[byHash[i - 1]]) {
+            std::cerr << "[StopwordTable] Stopwords \"" << words[byHash[i - 1]] << "\" and \"" << words[byHash[i]] << "\" have the same hash\n";
+            return false;
+        }
+    }
+
+    // About four words per bucket, table at most 80% full
+    std::size_t bucketCount = words.size() / 4 + 1;
+    std::size_t tableSize = 8;
+    while (tableSize * 4 < words.size() * 5)
+        tableSize *= 2;
+
+    // Group words into buckets
+    std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+    for (std::size_t i = 0; i < words.size(); i++)
+        buckets[(hashes[i] >> 32) % bucketCount].push_back(static_cast<std::uint32_t>(i));
+    // Place the largest buckets first, while the table is still empty
+    std::vector<std::uint32_t> order(bucketCount);
+    for (std::size_t b = 0; b < bucketCount; b++)
+        order[b] = static_cast<std::uint32_t>(b);
+    std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    // Find a displacement seed for every bucket; double the table if some bucket cannot be placed
+    std::vector<std::size_t> placed;
+    for (int doublings = 0; doublings <= kMaxDoublings; doublings++) {
+        slots.assign(tableSize, 0);
+        seeds.assign(bucketCount, 0);
+        slotMask = tableSize - 1;
+        bool complete = true;
+        for (std::uint32_t b : order) {
+            const auto& members = buckets[b];
+            if (members.empty())
+                continue;
+            bool found = false;
+            for (std::uint32_t seed = 0; seed < 65536 && !found; seed++) {
+                // Tentatively place every member, undoing on the first collision
+                placed.clear();
+                found = true;
+                for (std::uint32_t w : members) {
+                    std::size_t slot = mixSeed(hashes[w], seed) & slotMask;
+                    if (slots[slot] != 0) {
+                        found = false;
+                        break;
+                    }
+                    slots[slot] = w + 1;
+                    placed.push_back(slot);
+                }
+                if (!found)
+                    for (std::size_t slot : placed)
+                        slots[slot] = 0;
+                else
+                    seeds[b] = seed;
+            }
+            if (!found) {
+                complete = false;
+                break;
+            }
+        }
+        if (complete)
+            return true;
+        tableSize *= 2;
+    }
+    return false;
+}
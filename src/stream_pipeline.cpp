@@ -0,0 +1,210 @@
+#include "../include/stream_pipeline.h"
+#include "../include/bounded_queue.h"
+#include "../include/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Objective :- Counting semaphore measured in bytes that caps the estimated memory of batches in flight
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class MemoryBudget {
+public:
+    // Objective :- Initialize budget with a byte limit
+    // Input :- limit - maximum number of bytes that may be held at once
+    // Output :- None (constructor)
+    // Sideeffect :- Stores limit
+    // Assumption :- None
+    explicit MemoryBudget(std::size_t limit) : limit(limit) {}
+
+    // Objective :- Reserve bytes, waiting until enough of the budget is free
+    // Input :- bytes - amount to reserve
+    // Output :- None (void function)
+    // Sideeffect :- Blocks while the budget is exhausted; an oversized request proceeds once nothing else is held
+    // Assumption :- Every acquire is matched by a release of the same amount
+    void acquire(std::size_t bytes) {
+        std::unique_lock<std::mutex> lock(mutex);
+        freed.wait(lock, [&] { return held == 0 || held + bytes <= limit; });
+        held += bytes;
+        peak = std::max(peak, held);
+    }
+
+    // Objective :- Return previously reserved bytes to the budget
+    // Input :- bytes - amount to release
+    // Output :- None (void function)
+    // Sideeffect :- Wakes a waiting producer
+    // Assumption :- bytes were acquired earlier
+    void release(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        held -= bytes;
+        freed.notify_all();
+    }
+
+    // Objective :- Report the highest number of bytes held at once
+    // Input :- None
+    // Output :- Returns peak held bytes
+    // Sideeffect :- None
+    // Assumption :- None
+    std::size_t high() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return peak;
+    }
+
+private:
+    std::size_t limit;               // Maximum bytes held at once
+    std::size_t held = 0;            // Bytes currently reserved
+    std::size_t peak = 0;            // Highest value of held
+    std::mutex mutex;                // Guards held and peak
+    std::condition_variable freed;   // Signalled whenever bytes are released
+};
+
+// Objective :- Represents a preprocessed batch waiting to be consumed
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct ProcessedBatch {
+    std::size_t sequence{};              // Position of the batch in load order
+    std::size_t cost{};                  // Budget bytes held by the batch
+    std::vector<ProcessedLine> lines;    // Processed lines of the batch
+};
+
+// Objective :- Estimate the memory a batch occupies from loading until it is consumed
+// Input :- batch - raw line batch
+// Output :- Returns estimated bytes (original and cleaned copies, token IDs and per-line bookkeeping)
+// Sideeffect :- None
+// Assumption :- None
+static std::size_t batchCost(const LineBatch& batch) {
+    return batch.bytes * 4 + batch.lines.size() * (sizeof(std::string_view) + sizeof(ProcessedLine) + 64);
+}
+
+// Objective :- Initialize the pipeline with a preprocessor, a memory budget and a worker count
+// Input :- pre - preprocessor used by the worker and consumer stages, memoryBudget - cap in bytes on batches in flight, threads - preprocessing workers (0 = all cores)
+// Output :- None (constructor)
+// Sideeffect :- Stores settings and derives the batch size from the budget
+// Assumption :- pre outlives the pipeline and is not used elsewhere while a run is in progress
+StreamPipeline::StreamPipeline(Preprocessor& pre, std::size_t memoryBudget, std::size_t threads)
+    : pre(pre),
+      memoryBudget(memoryBudget),
+      threads(parallel::resolveThreads(threads)) {
+    // Size batches so every worker can hold a couple of them within the budget (batch cost is about 4x its text)
+    batchBytes = std::max<std::size_t>(1024, memoryBudget / (4 * 2 * (this->threads + 2)));
+}
+
+// Objective :- Stream all input files through preprocessing and hand each processed batch to a consumer in load order
+// Input :- fm - file manager describing the inputs, consume - callback run on the calling thread for every processed batch, stats - optional pointer receiving run statistics, intern - false to hand over normalized lines without tokens (the consumer interns them itself, e.g. into a batch-local vocabulary)
+// Output :- Returns false if the input path is invalid, true otherwise
+// Sideeffect :- Starts a loader thread and worker threads (which normalize), interns tokens on the calling thread unless intern is false, blocks the loader whenever the budget is exhausted, calls consume for every batch
+// Assumption :- consume does not keep references into batches it does not copy; memory it retains is not covered by the budget
+bool StreamPipeline::run(const FileManager& fm,
+                         const std::function<void(std::vector<ProcessedLine>&)>& consume,
+                         Stats* stats, bool intern) const {
+    // Start timing the run
+    auto started = std::chrono::steady_clock::now();
+
+    // Budget shared by all stages
+    MemoryBudget budget(memoryBudget);
+    // Queue from the loader to the workers
+    BoundedQueue<LineBatch> rawQueue(threads * 2);
+    // Queue from the workers to the consumer (the budget, not this capacity, limits what is in flight)
+    BoundedQueue<ProcessedBatch> doneQueue(threads * 4);
+
+    // Loader stage: stream batches from disk, reserving budget before each one
+    bool pathOk = true;
+    std::size_t rawBytes = 0;
+    std::thread loader([&]() {
+        pathOk = fm.streamBatches(batchBytes, [&](LineBatch&& batch) {
+            budget.acquire(batchCost(batch));
+            rawBytes += batch.bytes;
+            return rawQueue.push(std::move(batch));
+        });
+        rawQueue.close();
+    });
+
+    // Worker stage: copy and normalize batches (the vocabulary is not touched here); the last worker to finish closes the output queue
+    std::atomic<std::size_t> running{threads};
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            LineBatch batch;
+            while (rawQueue.pop(batch)) {
+                ProcessedBatch out;
+                out.sequence = batch.sequence;
+                out.cost = batchCost(batch);
+                out.lines = pre.normalizeLines(batch.lines);
+                doneQueue.push(std::move(out));
+            }
+            if (--running == 0)
+                doneQueue.close();
+        });
+    }
+
+    // Consumer stage (calling thread): restore load order, intern tokens, consume, give the budget back
+    std::map<std::size_t, ProcessedBatch> pending;
+    std::size_t nextSequence = 0, batches = 0, lines = 0;
+    ProcessedBatch batch;
+    while (doneQueue.pop(batch)) {
+        pending.emplace(batch.sequence, std::move(batch));
+        // Consume every batch that is next in order
+        for (auto it = pending.find(nextSequence); it != pending.end(); it = pending.find(nextSequence)) {
+            // Interning in load order keeps token IDs independent of worker timing
+            if (intern)
+                pre.internTokens(it->second.lines);
+            consume(it->second.lines);
+            // Count after consuming: a consumer that interns itself drops the lines without tokens
+            lines += it->second.lines.size();
+            budget.release(it->second.cost);
+            pending.erase(it);
+            nextSequence++;
+            batches++;
+        }
+    }
+
+    // Wait for all stages to finish
+    loader.join();
+    for (auto& w : workers)
+        w.join();
+
+    // Report statistics
+    if (stats) {
+        stats->batches = batches;
+        stats->lines = lines;
+        stats->bytes = rawBytes;
+        stats->peakBytes = budget.high();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+    // Report whether the input path was usable
+    return pathOk;
+}
+
+// Objective :- Stream all input files and count token frequencies without materializing the corpus
+// Input :- fm - file manager describing the inputs, ex - keyword extractor used by the counting stage, counts - frequency vector (indexed by token ID) receiving the totals, stats - optional pointer receiving run statistics
+// Output :- Returns false if the input path is invalid, true otherwise
+// Sideeffect :- Runs the pipeline, updates counts
+// Assumption :- counts may already hold totals to add to
+bool StreamPipeline::countTokens(const FileManager& fm, const KeywordExtractor& ex,
+                                 std::vector<std::uint32_t>& counts,
+                                 Stats* stats) const {
+    // Counting stage consumes batches as they arrive and drops them
+    return run(fm, [&](std::vector<ProcessedLine>& lines) { ex.accumulate(lines, counts); }, stats);
+}
+
+// Objective :- Stream all input files and count token frequencies approximately in the fixed memory of a sketch, leaving the shared vocabulary untouched
+// Input :- fm - file manager describing the inputs, sketch - sketch receiving the counts, stats - optional pointer receiving run statistics
+// Output :- Returns false if the input path is invalid, true otherwise
+// Sideeffect :- Runs the pipeline, interns each batch into a vocabulary dropped after the batch, updates sketch
+// Assumption :- sketch may already hold counts to add to
+bool StreamPipeline::countTokens(const FileManager& fm, KeywordSketch& sketch, Stats* stats) const {
+    // Counting stage tokenizes each batch against its own vocabulary, so nothing grows with the corpus except the sketch's fixed tables
+    return run(fm, [&](std::vector<ProcessedLine>& lines) {
+        Vocabulary local;
+        pre.internTokens(lines, local);
+        sketch.accumulate(lines, local);
+    }, stats, false);
+}
@@ -0,0 +1,363 @@
+#include "../include/text_ranker.h"
+#include "../include/parallel.h"
+#include "../include/top_k.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Lines per task when building the graph and iterating; fixed so the per-block partial sums, and with them the ranks, do not depend on the thread count
+static const std::size_t kBlockLines = 4096;
+
+// Average number of line pairs per line the candidate search may visit; a token in d lines costs d * d visits when all of them link through it, so only the rarest
+// tokens do, and each line reaches the other lines of a more common token (like a stopword it says little about similarity) only through a window of them, which keeps
+// the search linear in the number of lines
+static const std::size_t kPairsPerLine = 256;
+
+// Power iteration stops when the ranks (summing to 1) change by less than this in total, i.e. by 0.01% of its rank per line on average, or after kMaxIterations rounds
+static const double kTolerance = 1e-4;
+static const std::size_t kMaxIterations = 100;
+
+// Objective :- Represents a weighted link to another line
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct Link {
+    std::uint32_t line{};       // Corpus-wide index of the linked line
+    float weight{};             // Similarity of the two lines
+};
+
+// Objective :- Ranking of scored lines: higher score first, then earlier line
+// Input :- a, b - lines to compare
+// Output :- Returns true if a ranks before b
+// Sideeffect :- None
+// Assumption :- None
+static bool ranksBefore(const ScoredRef& a, const ScoredRef& b) {
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.index < b.index;
+}
+
+// Objective :- Ranking of candidate links: more similar first, then earlier line
+// Input :- a, b - links to compare
+// Output :- Returns true if a ranks before b
+// Sideeffect :- None
+// Assumption :- None
+static bool linksBefore(const Link& a, const Link& b) {
+    if (a.weight != b.weight)
+        return a.weight > b.weight;
+    return a.line < b.line;
+}
+
+// Objective :- Initialize the ranker with the graph and iteration settings
+// Input :- neighbors - most similar lines each line links to, damping - probability of following a link instead of jumping to a random line
+// Output :- None (constructor)
+// Sideeffect :- Stores settings
+// Assumption :- None (neighbors is at least 1, damping is clamped to [0, 1))
+TextRanker::TextRanker(std::size_t neighbors, double damping)
+    : neighbors(std::max<std::size_t>(1, neighbors)), damping(std::min(0.99, std::max(0.0, damping))) {}
+
+// Objective :- Rank every line with tokens by centrality
+// Input :- corpus - processed lines to rank, stats - optional pointer receiving graph size, iteration count and elapsed time
+// Output :- Returns vector of ScoredLine objects (viewing lines of corpus) sorted by score in descending order, earlier lines first on ties; an average line scores 1
+// Sideeffect :- Builds and releases the similarity graph (see scoreTop), may fill *stats
+// Assumption :- corpus may be empty, the arenas outlive the result
+std::vector<ScoredLine> TextRanker::score(const Corpus& corpus, RankStats* stats) const {
+    // Rank all lines, then resolve the references into views
+    auto refs = scoreTop(corpus, corpus.size(), stats);
+    std::vector<ScoredLine> lines;
+    lines.reserve(refs.size());
+    for (const auto& ref : refs)
+        lines.push_back(ScoredLine{corpus.line(ref.index), ref.score});
+    return lines;
+}
+
+// Objective :- Rank lines by centrality and return only the best 'limit' of them
+// Input :- corpus - processed lines to rank, limit - number of lines needed (e.g. QuestionGenerator::linesNeeded), stats - optional pointer receiving ranking statistics
+// Output :- Returns references (corpus-wide line index and score) to the first 'limit' lines of score(corpus)
+// Sideeffect :- Builds an inverted index, the links and the CSR matrix on 'threads' workers and releases them on return; may fill *stats
+// Assumption :- Same as score(); results do not depend on the thread count
+std::vector<ScoredRef> TextRanker::scoreTop(const Corpus& corpus, std::size_t limit, RankStats* stats) const {
+    // Start timing the ranking
+    auto started = std::chrono::steady_clock::now();
+    if (stats)
+        *stats = RankStats{};
+
+    // Nothing to rank
+    const std::size_t n = corpus.size();
+    if (n == 0 || limit == 0)
+        return {};
+    const std::size_t blocks = (n + kBlockLines - 1) / kBlockLines;
+
+    // Tokens of every line, walking the arenas once; each line's distinct tokens will fit in the room of all its tokens
+    std::vector<TokenSpan> spans;
+    spans.reserve(n);
+    std::vector<std::size_t> start(n + 1, 0);
+    for (const auto& doc : corpus.documents()) {
+        const TokenId* data = doc->tokenData();
+        const std::uint32_t* offsets = doc->tokenOffsets();
+        for (std::size_t i = 0; i < doc->size(); i++) {
+            spans.push_back(TokenSpan{data + offsets[i], offsets[i + 1] - offsets[i]});
+            start[spans.size()] = start[spans.size() - 1] + spans.back().count;
+        }
+    }
+
+    // Sorted distinct tokens of each line, and the largest token ID of each block
+    std::vector<TokenId> distinct(start[n]);
+    std::vector<std::uint32_t> distinctCount(n, 0);
+    std::vector<TokenId> blockMax(blocks, 0);
+    parallel::forEach(blocks, threads, [&](std::size_t b) {
+        for (std::size_t i = b * kBlockLines; i < std::min(n, (b + 1) * kBlockLines); i++) {
+            TokenId* first = distinct.data() + start[i];
+            std::copy(spans[i].begin(), spans[i].end(), first);
+            std::sort(first, first + spans[i].count);
+            TokenId* last = std::unique(first, first + spans[i].count);
+            distinctCount[i] = static_cast<std::uint32_t>(last - first);
+            if (last != first)
+                blockMax[b] = std::max(blockMax[b], *(last - 1));
+        }
+    });
+    spans.clear();
+    spans.shrink_to_fit();
+
+    // Lines with tokens are the graph's nodes; a line without tokens ranks nowhere
+    std::size_t nodes = 0;
+    for (std::size_t i = 0; i < n; i++)
+        nodes += distinctCount[i] > 0;
+    if (nodes == 0)
+        return {};
+
+    // Number of lines containing each token
+    const std::size_t vocabSize = static_cast<std::size_t>(*std::max_element(blockMax.begin(), blockMax.end())) + 1;
+    std::vector<std::uint32_t> postingStart(vocabSize + 1, 0);
+    for (std::size_t i = 0; i < n; i++)
+        for (std::size_t k = 0; k < distinctCount[i]; k++)
+            postingStart[distinct[start[i] + k] + 1]++;
+
+    // Most lines a token may be in and still link all of them: the rarest tokens first, until their line pairs use up the budget. Through every token in more lines
+    // (the rarest ones too when they alone are over budget) a line reaches only the 'window' lines around it in the token's posting list, as many as what the budget
+    // has left allows for all of their lines but never fewer than 'neighbors'; so every token in 2 or more lines links lines, and no line gets more links than another
+    std::uint32_t maxLines = 0;
+    std::uint32_t window = 0;
+    {
+        std::vector<std::uint32_t> lineCounts;
+        for (std::size_t t = 1; t <= vocabSize; t++)
+            if (postingStart[t] >= 2)
+                lineCounts.push_back(postingStart[t]);
+        std::sort(lineCounts.begin(), lineCounts.end());
+        const double budget = static_cast<double>(kPairsPerLine) * static_cast<double>(n);
+        double pairs = 0.0;
+        std::size_t k = 0;
+        while (k < lineCounts.size()) {
+            // All tokens in the same number of lines go in or stay out together
+            std::size_t same = k;
+            while (same < lineCounts.size() && lineCounts[same] == lineCounts[k])
+                same++;
+            double classPairs = static_cast<double>(same - k) * lineCounts[k] * lineCounts[k];
+            if (pairs + classPairs > budget)
+                break;
+            pairs += classPairs;
+            maxLines = lineCounts[k];
+            k = same;
+        }
+        double windowedLines = 0.0;
+        for (; k < lineCounts.size(); k++)
+            windowedLines += lineCounts[k];
+        if (windowedLines > 0.0)
+            window = static_cast<std::uint32_t>(std::min<double>(std::max<double>(static_cast<double>(neighbors), (budget - pairs) / windowedLines), n));
+    }
+
+    // Inverted index over the tokens that can link lines (in 2 or more lines), each list in line order
+    for (std::size_t t = 1; t <= vocabSize; t++) {
+        std::uint32_t lines = postingStart[t];
+        postingStart[t] = postingStart[t - 1] + (lines >= 2 ? lines : 0);
+    }
+    std::vector<std::uint32_t> postings(postingStart[vocabSize]);
+    {
+        std::vector<std::uint32_t> fill(postingStart.begin(), postingStart.end() - 1);
+        for (std::size_t i = 0; i < n; i++)
+            for (std::size_t k = 0; k < distinctCount[i]; k++) {
+                TokenId t = distinct[start[i] + k];
+                if (postingStart[t + 1] > postingStart[t])
+                    postings[fill[t]++] = static_cast<std::uint32_t>(i);
+            }
+    }
+
+    // log(1 + distinct tokens) of every line, the length term of the similarity
+    std::vector<float> logLength(n);
+    for (std::size_t i = 0; i < n; i++)
+        logLength[i] = static_cast<float>(std::log(1.0 + distinctCount[i]));
+
+    // Link every line to its 'neighbors' most similar lines: count shared tokens through the inverted index (never comparing lines that share nothing),
+    // weigh them by overlap / (log(1 + |Si|) + log(1 + |Sj|)) as TextRank does, keep the best
+    const std::size_t workers = std::min(parallel::resolveThreads(threads), blocks);
+    std::vector<Link> knn(n * neighbors);
+    std::vector<std::uint32_t> knnCount(n, 0);
+    std::vector<std::vector<std::uint8_t>> overlap(workers);
+    std::vector<std::vector<std::uint32_t>> touched(workers);
+    parallel::forEachWorker(blocks, workers, [&](std::size_t b, std::size_t w) {
+        // Per-worker shared-token counters (a byte per line so they stay in cache, saturating at 255), all zero between lines
+        auto& shared = overlap[w];
+        auto& seen = touched[w];
+        if (shared.empty())
+            shared.assign(n, 0);
+
+        for (std::size_t i = b * kBlockLines; i < std::min(n, (b + 1) * kBlockLines); i++) {
+            // Count the tokens line i shares with every line reachable through its postings (for a token in more than maxLines lines, the window centred on line i)
+            for (std::size_t k = 0; k < distinctCount[i]; k++) {
+                TokenId t = distinct[start[i] + k];
+                std::uint32_t first = postingStart[t], last = postingStart[t + 1];
+                if (last - first > maxLines && last - first > window) {
+                    std::uint32_t at = static_cast<std::uint32_t>(std::lower_bound(postings.begin() + first, postings.begin() + last, i) - postings.begin());
+                    first = std::min(at - first >= window / 2 ? at - window / 2 : first, last - window);
+                    last = first + window;
+                }
+                for (std::uint32_t p = first; p < last; p++) {
+                    std::uint32_t j = postings[p];
+                    if (j == i || shared[j] == 255)
+                        continue;
+                    if (shared[j]++ == 0)
+                        seen.push_back(j);
+                }
+            }
+            if (seen.empty())
+                continue;
+
+            // Weigh the candidates, keeping the most similar ones (a total order, so the choice does not depend on the worker), and clear the counters behind them
+            TopK<Link, bool (*)(const Link&, const Link&)> best(neighbors, linksBefore);
+            for (std::uint32_t j : seen) {
+                best.push(Link{j, static_cast<float>(shared[j]) / (logLength[i] + logLength[j])});
+                shared[j] = 0;
+            }
+            seen.clear();
+            auto kept = best.take();
+            std::size_t keep = kept.size();
+            std::copy(kept.begin(), kept.end(), knn.begin() + i * neighbors);
+            knnCount[i] = static_cast<std::uint32_t>(keep);
+        }
+    });
+    overlap.clear();
+    postings.clear();
+    postings.shrink_to_fit();
+
+    // Symmetric CSR matrix: each kept link in both rows (similarity is symmetric, so a link kept by both lines appears twice with the same weight)
+    std::vector<std::size_t> rowStart(n + 1, 0);
+    for (std::size_t i = 0; i < n; i++)
+        for (std::size_t k = 0; k < knnCount[i]; k++) {
+            rowStart[i + 1]++;
+            rowStart[knn[i * neighbors + k].line + 1]++;
+        }
+    for (std::size_t i = 0; i < n; i++)
+        rowStart[i + 1] += rowStart[i];
+    std::vector<Link> matrix(rowStart[n]);
+    {
+        std::vector<std::size_t> fill(rowStart.begin(), rowStart.end() - 1);
+        for (std::size_t i = 0; i < n; i++)
+            for (std::size_t k = 0; k < knnCount[i]; k++) {
+                const Link& link = knn[i * neighbors + k];
+                matrix[fill[i]++] = link;
+                matrix[fill[link.line]++] = Link{static_cast<std::uint32_t>(i), link.weight};
+            }
+    }
+    knn.clear();
+    knn.shrink_to_fit();
+
+    // Sort each row by column and drop the duplicates; rows keep their room, so rowLength marks where each one ends. The row's total weight is its line's strength
+    std::vector<std::uint32_t> rowLength(n, 0);
+    std::vector<double> strength(n, 0.0);
+    std::vector<std::size_t> blockEdges(blocks, 0);
+    parallel::forEach(blocks, threads, [&](std::size_t b) {
+        for (std::size_t i = b * kBlockLines; i < std::min(n, (b + 1) * kBlockLines); i++) {
+            auto first = matrix.begin() + rowStart[i];
+            auto last = matrix.begin() + rowStart[i + 1];
+            std::sort(first, last, [](const Link& x, const Link& y) { return x.line < y.line; });
+            last = std::unique(first, last, [](const Link& x, const Link& y) { return x.line == y.line; });
+            rowLength[i] = static_cast<std::uint32_t>(last - first);
+            for (auto it = first; it != last; ++it)
+                strength[i] += it->weight;
+            blockEdges[b] += rowLength[i];
+        }
+    });
+
+    // Power iteration from the uniform ranks: rank(i) = (1 - d) / nodes + d * sum_j weight(i, j) / strength(j) * rank(j);
+    // lines with no links spread their rank evenly like the random jump does
+    std::vector<double> rank(n, 0.0);
+    for (std::size_t i = 0; i < n; i++)
+        if (distinctCount[i] > 0)
+            rank[i] = 1.0 / static_cast<double>(nodes);
+    std::vector<double> next(n, 0.0);
+    std::vector<float> share(n, 0.0f);
+    std::vector<double> blockSum(blocks, 0.0);
+    std::size_t iteration = 0;
+    while (iteration < kMaxIterations) {
+        iteration++;
+
+        // What each line passes along per unit of link weight, and the rank held by lines without links
+        parallel::forEach(blocks, threads, [&](std::size_t b) {
+            double isolated = 0.0;
+            for (std::size_t i = b * kBlockLines; i < std::min(n, (b + 1) * kBlockLines); i++) {
+                share[i] = strength[i] > 0.0 ? static_cast<float>(rank[i] / strength[i]) : 0.0f;
+                if (strength[i] == 0.0)
+                    isolated += rank[i];
+            }
+            blockSum[b] = isolated;
+        });
+        double isolated = 0.0;
+        for (double s : blockSum)
+            isolated += s;
+        const double base = ((1.0 - damping) + damping * isolated) / static_cast<double>(nodes);
+
+        // Pull the new ranks along each row, summing the change per block
+        parallel::forEach(blocks, threads, [&](std::size_t b) {
+            double change = 0.0;
+            for (std::size_t i = b * kBlockLines; i < std::min(n, (b + 1) * kBlockLines); i++) {
+                if (distinctCount[i] == 0)
+                    continue;
+                double pulled = 0.0;
+                const Link* row = matrix.data() + rowStart[i];
+                for (std::uint32_t k = 0; k < rowLength[i]; k++)
+                    pulled += row[k].weight * share[row[k].line];
+                next[i] = base + damping * pulled;
+                change += std::fabs(next[i] - rank[i]);
+            }
+            blockSum[b] = change;
+        });
+        rank.swap(next);
+
+        // Stop once the ranks have settled (block sums added in block order, so the stopping point is the same for any thread count)
+        double change = 0.0;
+        for (double s : blockSum)
+            change += s;
+        if (change < kTolerance)
+            break;
+    }
+
+    // Best 'limit' lines, scaled so an average line scores 1
+    TopK<ScoredRef, bool (*)(const ScoredRef&, const ScoredRef&)> top(std::min(limit, nodes), ranksBefore);
+    for (std::size_t i = 0; i < n; i++)
+        if (distinctCount[i] > 0)
+            top.push(ScoredRef{static_cast<std::uint32_t>(i), static_cast<float>(rank[i] * static_cast<double>(nodes))});
+
+    // Fill in statistics if requested
+    if (stats) {
+        stats->lines = nodes;
+        for (std::size_t e : blockEdges)
+            stats->edges += e;
+        stats->edges /= 2;
+        stats->iterations = iteration;
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+    return top.take();
+}
+
+// Objective :- Set the number of worker threads used to build the graph and iterate (results do not depend on it)
+// Input :- count - number of threads (0 means one per hardware thread, 1 ranks on the calling thread)
+// Output :- None (void function)
+// Sideeffect :- Updates member variable threads
+// Assumption :- None
+void TextRanker::setThreads(std::size_t count) {
+    // Store thread count
+    threads = count;
+}
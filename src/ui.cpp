@@ -1,4 +1,5 @@
 #include "../include/ui.h"
+#include <iomanip>
 #include <iostream>
 #include <string>
 
@@ -62,5 +63,74 @@ void summarize(const QuestionPaper& p) {
     std::cout << "  Long Qs: " << p.longQuestions.size() << "\n";
 }
 
+// Objective :- Display how many documents were loaded and the load throughput
+// Input :- files - number of documents loaded, bytes - total bytes loaded, seconds - time spent loading, unchanged - number of documents reused from the previous run
+// Output :- None (void function)
+// Sideeffect :- Writes load statistics to standard output
+// Assumption :- seconds is non-negative
+void reportLoad(std::size_t files, std::size_t bytes, double seconds, std::size_t unchanged) {
+    // Convert bytes to megabytes for display
+    double megabytes = bytes / (1024.0 * 1024.0);
+    // Display counts and elapsed time
+    std::cout << "Loaded " << files << " file(s), " << std::fixed << std::setprecision(2)
+              << megabytes << " MB in " << seconds * 1000.0 << " ms";
+    // Display throughput when the load took measurable time
+    if (seconds > 0.0)
+        std::cout << " (" << megabytes / seconds << " MB/s, " << files / seconds << " files/s)";
+    // Display how many documents were reused unchanged
+    if (unchanged > 0)
+        std::cout << ", " << unchanged << " unchanged";
+    std::cout << "\n";
+    // Restore default float formatting
+    std::cout << std::defaultfloat;
+}
+
+// Objective :- Display the result of a streaming pass: lines processed, throughput and peak memory in flight
+// Input :- lines - number of processed lines, bytes - raw bytes streamed, peakBytes - highest memory held by batches in flight, seconds - time of the pass
+// Output :- None (void function)
+// Sideeffect :- Writes streaming statistics to standard output
+// Assumption :- seconds is non-negative
+void reportStream(std::size_t lines, std::size_t bytes, std::size_t peakBytes, double seconds) {
+    // Convert bytes to megabytes for display
+    double megabytes = bytes / (1024.0 * 1024.0);
+    // Display line count, volume, time and peak memory in flight
+    std::cout << "Streamed " << lines << " line(s), " << std::fixed << std::setprecision(2)
+              << megabytes << " MB in " << seconds * 1000.0 << " ms";
+    // Display throughput when the pass took measurable time
+    if (seconds > 0.0)
+        std::cout << " (" << megabytes / seconds << " MB/s)";
+    std::cout << ", peak in flight " << peakBytes / (1024.0 * 1024.0) << " MB\n";
+    // Restore default float formatting
+    std::cout << std::defaultfloat;
+}
+
+// Objective :- Display the error bounds of approximate keyword counts
+// Input :- tokens - occurrences counted (N), counters - Space-Saving counters (k), epsilon - Count-Min error factor, delta - Count-Min failure probability
+// Output :- None (void function)
+// Sideeffect :- Writes the bounds to standard output
+// Assumption :- counters > 0
+void reportSketch(std::uint64_t tokens, std::size_t counters, double epsilon, double delta) {
+    // Keyword counts overestimate by at most N / k; line scores use estimates within epsilon * N with probability 1 - delta
+    std::cout << "Approximate counts over " << tokens << " token(s): keywords within +"
+              << tokens / counters << ", scoring estimates within +"
+              << static_cast<std::uint64_t>(epsilon * tokens) << " (" << std::fixed << std::setprecision(2)
+              << (1.0 - delta) * 100.0 << "% confidence)\n";
+    // Restore default float formatting
+    std::cout << std::defaultfloat;
+}
+
+// Objective :- Display the result of a TextRank ranking: graph size, iterations and time
+// Input :- lines - graph nodes (lines with tokens), edges - links between similar lines, iterations - power iterations run, seconds - time of the ranking
+// Output :- None (void function)
+// Sideeffect :- Writes ranking statistics to standard output
+// Assumption :- seconds is non-negative
+void reportRank(std::size_t lines, std::size_t edges, std::size_t iterations, double seconds) {
+    // Display graph size, iteration count and elapsed time
+    std::cout << "Ranked " << lines << " line(s) by centrality over " << edges << " link(s) in "
+              << iterations << " iteration(s), " << std::fixed << std::setprecision(2) << seconds * 1000.0 << " ms\n";
+    // Restore default float formatting
+    std::cout << std::defaultfloat;
+}
+
 } // namespace ui
 
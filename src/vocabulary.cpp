@@ -0,0 +1,49 @@
+#include "../include/vocabulary.h"
+#include <string>
+#include <string_view>
+
+// Objective :- Return the ID of a token, assigning the next free ID if the token is new
+// Input :- token - view of the token text
+// Output :- Returns the token's ID
+// Sideeffect :- Stores a copy of new tokens
+// Assumption :- Not called concurrently with any other member function
+TokenId Vocabulary::intern(std::string_view token) {
+    // Known token: return its ID
+    const TokenId* known = ids.find(token);
+    if (known)
+        return *known;
+    // New token: store a copy and key the map by a view of that copy
+    TokenId id = static_cast<TokenId>(strings.size());
+    strings.emplace_back(token);
+    ids.insert(strings.back(), id);
+    // Return new ID
+    return id;
+}
+
+// Objective :- Look up the ID of a token without adding it
+// Input :- token - view of the token text
+// Output :- Returns the token's ID, or npos if it was never interned
+// Sideeffect :- None
+// Assumption :- None
+TokenId Vocabulary::find(std::string_view token) const {
+    const TokenId* known = ids.find(token);
+    return known ? *known : npos;
+}
+
+// Objective :- Return the text of an interned token
+// Input :- id - token ID returned by intern()
+// Output :- Returns reference to the token text
+// Sideeffect :- None
+// Assumption :- id < size(); the reference stays valid for the lifetime of the vocabulary
+const std::string& Vocabulary::text(TokenId id) const {
+    return strings[id];
+}
+
+// Objective :- Report the number of interned tokens (one past the largest ID)
+// Input :- None
+// Output :- Returns the number of interned tokens
+// Sideeffect :- None
+// Assumption :- None
+std::size_t Vocabulary::size() const {
+    return strings.size();
+}
@@ -0,0 +1,202 @@
+#include "../include/flat_hash_map.h"
+#include "../include/vocabulary.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Objective :- Hash functor sending 64 consecutive keys to one hash, so equal hashes, long probe runs and runs wrapping past the end of the slot array are common
+// Input :- key - integer key
+// Output :- Returns hash value
+// Sideeffect :- None
+// Assumption :- None
+struct ClusterHash {
+    std::size_t operator()(std::uint32_t key) const { return key / 64; }
+};
+
+// Objective :- Hash functor sending every key to one hash, so every entry shares one probe run
+// Input :- key - integer key
+// Output :- Returns hash value
+// Sideeffect :- None
+// Assumption :- None
+struct ConstantHash {
+    std::size_t operator()(std::uint32_t) const { return 7; }
+};
+
+// Objective :- Compare every key of the reference map with the flat map, and the sizes
+// Input :- name - label for messages, map - map under test, reference - expected contents
+// Output :- Returns true if both hold the same keys with the same values
+// Sideeffect :- None
+// Assumption :- None
+template <typename Map, typename Reference>
+static bool sameContents(const Map& map, const Reference& reference) {
+    if (map.size() != reference.size())
+        return false;
+    for (const auto& entry : reference) {
+        const auto* value = map.find(entry.first);
+        if (!value || *value != entry.second)
+            return false;
+    }
+    return true;
+}
+
+// Objective :- Apply a random sequence of inserts, operator[] updates, erases, finds, reserves and clears to a FlatHashMap of integer keys and to std::unordered_map,
+//              comparing every result and, every 1000 operations, the whole contents
+// Input :- Hash - hash functor under test, name - label to print, operations - number of operations, keys - size of the key range (small enough for keys to repeat)
+// Output :- Returns number of mismatches found
+// Sideeffect :- Writes a line to standard output and the first mismatches to standard error
+// Assumption :- None
+template <typename Hash>
+static std::size_t checkIntegers(const char* name, std::size_t operations, std::uint32_t keys) {
+    std::mt19937 rng(17);
+    FlatHashMap<std::uint32_t, std::uint32_t, Hash> map;
+    std::unordered_map<std::uint32_t, std::uint32_t> reference;
+    std::size_t failures = 0;
+    auto fail = [&](std::size_t op, const char* what) {
+        if (failures < 5)
+            std::cerr << "FlatHashMap " << name << " mismatch at operation " << op << " (" << what << ")\n";
+        failures++;
+    };
+
+    for (std::size_t op = 0; op < operations; op++) {
+        std::uint32_t key = rng() % keys, value = rng();
+        switch (rng() % 16) {
+        case 0:
+        case 1:
+        case 2:
+        case 3: {
+            auto inserted = map.insert(key, value);
+            auto expected = reference.insert({key, value});
+            if (inserted.second != expected.second || *inserted.first != expected.first->second)
+                fail(op, "insert");
+            break;
+        }
+        case 4:
+        case 5:
+            map[key] = value;
+            reference[key] = value;
+            break;
+        case 6:
+        case 7:
+        case 8:
+        case 9:
+        case 10:
+            if (map.erase(key) != (reference.erase(key) == 1))
+                fail(op, "erase");
+            break;
+        case 11:
+            // Grow the table in place (keeps every entry)
+            map.reserve(map.size() + rng() % 1000);
+            break;
+        case 12:
+            // Rarely start over, so the table also runs nearly empty
+            if (rng() % 500 == 0) {
+                map.clear();
+                reference.clear();
+            }
+            break;
+        default: {
+            const auto& constMap = map;
+            const std::uint32_t* found = constMap.find(key);
+            auto expected = reference.find(key);
+            if ((found != nullptr) != (expected != reference.end()) || (found && *found != expected->second))
+                fail(op, "find");
+            break;
+        }
+        }
+        if (op % 1000 == 999 && !sameContents(map, reference))
+            fail(op, "contents");
+    }
+    if (!sameContents(map, reference))
+        fail(operations, "final contents");
+    std::cout << "FlatHashMap " << name << ": " << operations << " operations, "
+              << (failures == 0 ? "identical to std::unordered_map" : "MISMATCH") << "\n";
+    return failures;
+}
+
+// Objective :- Apply random inserts, erases and finds to a FlatHashMap of std::string keys probed through std::string_view (views of a separate buffer, never of the stored keys)
+//              and check Vocabulary interning against a std::unordered_map of strings
+// Input :- operations - number of operations
+// Output :- Returns number of mismatches found
+// Sideeffect :- Writes a line to standard output and the first mismatches to standard error
+// Assumption :- None
+static std::size_t checkText(std::size_t operations) {
+    std::mt19937 rng(23);
+    // Words of 1-12 letters from a small alphabet, so many share prefixes and some are prefixes of others
+    auto word = [&]() {
+        std::string text(1 + rng() % 12, 'a');
+        for (char& c : text)
+            c = static_cast<char>('a' + rng() % 4);
+        return text;
+    };
+
+    FlatHashMap<std::string, int, TextHash> map;
+    std::unordered_map<std::string, int> reference;
+    Vocabulary vocab;
+    std::unordered_map<std::string, TokenId> ids;
+    std::size_t failures = 0;
+    auto fail = [&](std::size_t op, const char* what) {
+        if (failures < 5)
+            std::cerr << "FlatHashMap text mismatch at operation " << op << " (" << what << ")\n";
+        failures++;
+    };
+
+    std::string buffer;
+    for (std::size_t op = 0; op < operations; op++) {
+        std::string key = word();
+        // Probe with a view into a longer buffer, so a match must compare by length as well as bytes
+        buffer = key + "xyz";
+        std::string_view view(buffer.data(), key.size());
+        int value = static_cast<int>(rng());
+        switch (rng() % 4) {
+        case 0:
+            if (map.insert(key, value).second != reference.insert({key, value}).second)
+                fail(op, "insert");
+            break;
+        case 1:
+            if (map.erase(view) != (reference.erase(key) == 1))
+                fail(op, "erase by view");
+            break;
+        default: {
+            const int* found = map.find(view);
+            auto expected = reference.find(key);
+            if ((found != nullptr) != (expected != reference.end()) || (found && *found != expected->second))
+                fail(op, "find by view");
+            break;
+        }
+        }
+
+        // Vocabulary: IDs in first-seen order, stable on repeats, found by view
+        TokenId expectedId = ids.insert({key, static_cast<TokenId>(ids.size())}).first->second;
+        if (vocab.intern(view) != expectedId || vocab.find(view) != expectedId || vocab.text(expectedId) != key)
+            fail(op, "Vocabulary::intern");
+    }
+    if (!sameContents(map, reference))
+        fail(operations, "final contents");
+    if (vocab.size() != ids.size() || vocab.find("not a word") != Vocabulary::npos)
+        fail(operations, "Vocabulary size");
+    std::cout << "FlatHashMap text: " << operations << " operations by string_view, Vocabulary interning, "
+              << (failures == 0 ? "identical to std::unordered_map" : "MISMATCH") << "\n";
+    return failures;
+}
+
+// Objective :- Entry point of the hash map check run by "make test". Proves FlatHashMap (including its backward-shift erase and string_view lookups) behaves as std::unordered_map.
+// Input :- None
+// Output :- Returns 0 if every operation matches, 1 otherwise
+// Sideeffect :- Writes results to the console
+int main() {
+    std::size_t failures = checkIntegers<std::hash<std::uint32_t>>("std::hash", 1000000, 5000) +
+                           checkIntegers<ClusterHash>("clustered hash", 1000000, 5000) +
+                           checkIntegers<ConstantHash>("constant hash", 100000, 300) + checkText(300000);
+    if (failures > 0) {
+        std::cerr << failures << " mismatch(es)\n";
+        return 1;
+    }
+    std::cout << "FlatHashMap matches std::unordered_map.\n";
+    return 0;
+}
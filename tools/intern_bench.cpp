@@ -0,0 +1,202 @@
+#include "../include/flat_hash_map.h"
+#include "../include/vocabulary.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Objective :- Class interning tokens the way Vocabulary did before FlatHashMap: a std::unordered_map from views of the stored texts to IDs
+// Input :- None (class declaration)
+// Output :- None (class declaration)
+// Sideeffect :- None
+class NodeVocabulary {
+public:
+    // Objective :- Return the ID of a token, assigning the next free ID if the token is new
+    // Input :- token - view of the token text
+    // Output :- Returns the token's ID
+    // Sideeffect :- Stores a copy of new tokens
+    // Assumption :- None
+    TokenId intern(std::string_view token) {
+        auto it = ids.find(token);
+        if (it != ids.end())
+            return it->second;
+        TokenId id = static_cast<TokenId>(strings.size());
+        strings.emplace_back(token);
+        ids.emplace(strings.back(), id);
+        return id;
+    }
+
+private:
+    std::deque<std::string> strings;                      // Token texts indexed by ID
+    std::unordered_map<std::string_view, TokenId> ids;    // Token text (viewing strings) to ID
+};
+
+// Objective :- Build a token stream with Zipf-distributed words of 2-12 random letters
+// Input :- tokens - stream length, distinct - number of distinct words, seed - random seed
+// Output :- Returns the stream as views into one text buffer (returned through text)
+// Sideeffect :- Fills text with every occurrence, space separated
+// Assumption :- None
+static std::vector<std::string_view> makeStream(std::size_t tokens, std::size_t distinct, unsigned seed, std::string& text) {
+    std::mt19937 rng(seed);
+    std::vector<std::string> words(distinct);
+    for (auto& word : words) {
+        word.resize(2 + rng() % 11);
+        for (char& c : word)
+            c = static_cast<char>('a' + rng() % 26);
+    }
+    std::vector<double> cumulative(distinct);
+    double total = 0.0;
+    for (std::size_t id = 0; id < distinct; id++)
+        cumulative[id] = total += 1.0 / (id + 1);
+    std::uniform_real_distribution<double> uniform(0.0, total);
+
+    // Occurrences are copied into the text so interning reads them the way it reads a document, not from the word list
+    std::vector<std::size_t> picks(tokens);
+    for (auto& pick : picks)
+        pick = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin();
+    text.clear();
+    std::vector<std::size_t> starts;
+    starts.reserve(tokens);
+    for (std::size_t pick : picks) {
+        starts.push_back(text.size());
+        text += words[pick];
+        text += ' ';
+    }
+    std::vector<std::string_view> stream;
+    stream.reserve(tokens);
+    for (std::size_t i = 0; i < tokens; i++)
+        stream.emplace_back(text.data() + starts[i], words[picks[i]].size());
+    return stream;
+}
+
+// Objective :- Read the words of a text file as a token stream: runs of letters and digits, lowercased (as the preprocessor leaves them, stopwords included)
+// Input :- path - text file, text - buffer receiving the lowercased file
+// Output :- Returns the words as views into text (empty if the file cannot be read)
+// Sideeffect :- Reads the file into text
+// Assumption :- None
+static std::vector<std::string_view> readStream(const std::string& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    text = contents.str();
+    std::vector<std::string_view> stream;
+    for (std::size_t i = 0; i < text.size();) {
+        if (!std::isalnum(static_cast<unsigned char>(text[i]))) {
+            i++;
+            continue;
+        }
+        std::size_t start = i;
+        for (; i < text.size() && std::isalnum(static_cast<unsigned char>(text[i])); i++)
+            text[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+        stream.emplace_back(text.data() + start, i - start);
+    }
+    return stream;
+}
+
+// Objective :- Time a routine, keeping the best of several runs
+// Input :- name - label to print, items - number of items the routine handles, run - routine returning a checksum
+// Output :- Returns the checksum of the last run
+// Sideeffect :- Writes the best time and throughput to standard output
+// Assumption :- None
+template <typename Run>
+static std::uint64_t timeRun(const char* name, std::size_t items, Run&& run) {
+    double best = 0.0;
+    std::uint64_t checksum = 0;
+    for (int attempt = 0; attempt < 3; attempt++) {
+        auto started = std::chrono::steady_clock::now();
+        checksum = run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        if (attempt == 0 || seconds < best)
+            best = seconds;
+    }
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << best * 1000.0 << " ms" << std::setw(10) << items / best / 1e6 << " M/s\n"
+              << std::defaultfloat;
+    return checksum;
+}
+
+// Objective :- Time interning one token stream with a fresh vocabulary of each kind, and check both assign the same IDs
+// Input :- label - description of the stream, stream - tokens to intern
+// Output :- Returns true if both vocabularies assign the same IDs
+// Sideeffect :- Writes timings to standard output
+// Assumption :- None
+static bool benchIntern(const char* label, const std::vector<std::string_view>& stream) {
+    std::cout << "Interning " << label << " (best of 3):\n";
+    std::uint64_t node = timeRun("std::unordered_map", stream.size(), [&]() {
+        NodeVocabulary vocab;
+        std::uint64_t sum = 0;
+        for (std::string_view token : stream)
+            sum = sum * 31 + vocab.intern(token);
+        return sum;
+    });
+    std::uint64_t flat = timeRun("FlatHashMap (Vocabulary)", stream.size(), [&]() {
+        Vocabulary vocab;
+        std::uint64_t sum = 0;
+        for (std::string_view token : stream)
+            sum = sum * 31 + vocab.intern(token);
+        return sum;
+    });
+    return node == flat;
+}
+
+// Objective :- Entry point of the interning benchmark run by "make bench". Times Vocabulary (FlatHashMap) against the std::unordered_map it replaced on a text-like stream
+//              and a stream with a large vocabulary (and optionally the words of a real text), and probing of a small integer-keyed table
+// Input :- argv[1] - optional text file whose words are interned as a further stream (e.g. a folder's files joined with cat)
+// Output :- Returns 0, or 1 if the two vocabularies assign different IDs
+// Sideeffect :- Allocates the streams, writes timings to the console
+int main(int argc, char* argv[]) {
+    std::string text;
+    // Like a folder of course notes: 3M words, 1.5k distinct
+    bool same = benchIntern("3M tokens, 1.5k distinct", makeStream(3000000, 1500, 5, text));
+    // Like a large archive: 3M words, 300k distinct
+    same = benchIntern("3M tokens, 300k distinct", makeStream(3000000, 300000, 6, text)) && same;
+    if (argc > 1) {
+        std::vector<std::string_view> words = readStream(argv[1], text);
+        std::string label = "the " + std::to_string(words.size()) + " words of " + argv[1];
+        same = benchIntern(label.c_str(), words) && same;
+    }
+
+    // A small ID-to-ID table like the question generator's keyword index, probed with hits and misses
+    const std::size_t probes = 30000000;
+    std::mt19937 rng(8);
+    std::vector<TokenId> keys(probes);
+    for (auto& key : keys)
+        key = rng() % 200;
+    FlatHashMap<TokenId, TokenId> flatTable;
+    std::unordered_map<TokenId, TokenId> nodeTable;
+    for (TokenId id = 0; id < 200; id += 2) {
+        flatTable.insert(id, id * 3);
+        nodeTable.emplace(id, id * 3);
+    }
+    std::cout << "Probing a 100-key table " << probes / 1000000 << "M times (best of 3):\n";
+    std::uint64_t node = timeRun("std::unordered_map", probes, [&]() {
+        std::uint64_t sum = 0;
+        for (TokenId key : keys) {
+            auto it = nodeTable.find(key);
+            sum += it != nodeTable.end() ? it->second : 1;
+        }
+        return sum;
+    });
+    std::uint64_t flat = timeRun("FlatHashMap", probes, [&]() {
+        std::uint64_t sum = 0;
+        for (TokenId key : keys) {
+            const TokenId* value = flatTable.find(key);
+            sum += value ? *value : 1;
+        }
+        return sum;
+    });
+    same = same && node == flat;
+    std::cout << (same ? "Both maps give the same results.\n" : "The maps give DIFFERENT results!\n");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+#include "../include/corpus_pack.h"
+#include "../include/file_manager.h"
+#include <iostream>
+#include <string>
+
+// Objective :- Entry point of the corpus packing tool. Loads every .txt file of a folder and writes them into one packed corpus file that the generator can load with a single open and mapping.
+// Input :- argv[1] - folder (or .txt file) to pack, argv[2] - output .qpack path
+// Output :- Returns 0 on success, 1 on usage error or failure
+// Sideeffect :- Reads the input files, writes the packed corpus, writes progress and errors to the console
+int main(int argc, char* argv[]) {
+
+    // Require input folder and output path
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <folder> <output.qpack>\n";
+        return 1;
+    }
+
+    // Output path must carry the extension the generator recognizes
+    std::string outPath = argv[2];
+    if (!CorpusPack::isPackFile(outPath)) {
+        std::cerr << "Output file must have a .qpack extension: " << outPath << "\n";
+        return 1;
+    }
+
+    // Load all documents of the folder in name order
+    FileManager fm(argv[1]);
+    FileManager::LoadStats stats;
+    auto docs = fm.loadDocuments(&stats);
+    if (docs.empty()) {
+        std::cerr << "No .txt files found!\n";
+        return 1;
+    }
+
+    // Write the packed corpus
+    if (!CorpusPack::write(docs, outPath))
+        return 1;
+
+    // Report what was packed
+    std::cout << "Packed " << stats.files << " file(s), " << stats.bytes << " bytes into " << outPath << "\n";
+    return 0;
+}
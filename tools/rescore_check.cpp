@@ -0,0 +1,162 @@
+#include "../include/corpus.h"
+#include "../include/line_scorer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Lines per generated document; 64 of them make the 256k lines from which rescoreTop keeps state
+static const std::size_t kDocumentLines = 4096;
+
+// Token IDs drawn with Zipf frequencies (common words); IDs from here on are rare words, each new one used by a single document
+static const std::uint32_t kCommonWords = 20000;
+
+// Objective :- Represents the corpus under test: its documents in corpus order and the frequency of each token ID over all of them
+// Input :- None (data structure)
+// Output :- None (data structure)
+// Sideeffect :- None
+struct EditedCorpus {
+    std::vector<std::shared_ptr<const DocumentArena>> documents;   // Documents in corpus order
+    std::vector<std::uint32_t> freq;                                 // Frequency of each token ID
+};
+
+// Objective :- Add or subtract the token counts of one document
+// Input :- corpus - corpus whose frequencies change, doc - document, sign - +1 to add, -1 to subtract
+// Output :- None (void function)
+// Sideeffect :- Updates corpus.freq, growing it for new IDs
+// Assumption :- A subtracted document was added before
+static void countDocument(EditedCorpus& corpus, const DocumentArena& doc, int sign) {
+    const TokenId* tokens = doc.tokenData();
+    const std::uint32_t* offsets = doc.tokenOffsets();
+    for (std::uint32_t i = 0; i < offsets[doc.size()]; i++) {
+        if (tokens[i] >= corpus.freq.size())
+            corpus.freq.resize(tokens[i] + 1, 0);
+        corpus.freq[tokens[i]] += sign;
+    }
+}
+
+// Objective :- Generate one document of kDocumentLines lines of 0-7 tokens, in one of three kinds: Zipf-distributed common words (changes the largest frequency),
+//              mid-frequency words only (changes many lines but not the largest frequency) or mostly fresh rare words (changes few lines, the incremental case)
+// Input :- rng - random source, nextRare - next unused rare token ID
+// Output :- Returns the document arena
+// Sideeffect :- Advances rng and nextRare
+// Assumption :- None
+static std::shared_ptr<const DocumentArena> makeDocument(std::mt19937& rng, std::uint32_t& nextRare) {
+    static std::vector<double> cumulative;
+    if (cumulative.empty()) {
+        double total = 0.0;
+        for (std::uint32_t id = 0; id < kCommonWords; id++)
+            cumulative.push_back(total += 1.0 / (id + 1));
+    }
+    std::uniform_real_distribution<double> uniform(0.0, cumulative.back());
+    const int kind = rng() % 3;
+    const std::uint32_t firstRare = nextRare;
+    nextRare += 200;
+
+    std::vector<ProcessedLine> lines(kDocumentLines);
+    for (auto& line : lines) {
+        std::uint32_t length = rng() % 8;
+        for (std::uint32_t i = 0; i < length; i++) {
+            TokenId id;
+            if (kind == 0)
+                id = static_cast<TokenId>(std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin());
+            else if (kind == 1)
+                id = 2000 + rng() % (kCommonWords - 2000);
+            else
+                id = rng() % 64 == 0 ? 5000 + rng() % (kCommonWords - 5000) : firstRare + rng() % 200;
+            line.tokens.push_back(id);
+        }
+    }
+    return std::make_shared<const DocumentArena>(lines);
+}
+
+// Objective :- Compare two rankings reference by reference
+// Input :- a, b - rankings to compare
+// Output :- Returns true if both hold the same lines with the same scores in the same order
+// Sideeffect :- None
+// Assumption :- None
+static bool sameRanking(const std::vector<ScoredRef>& a, const std::vector<ScoredRef>& b) {
+    bool same = a.size() == b.size();
+    for (std::size_t i = 0; same && i < a.size(); i++)
+        same = a[i].index == b[i].index && a[i].score == b[i].score;
+    return same;
+}
+
+// Objective :- Apply a random sequence of edits to a corpus of 60-72 documents (246k-295k lines, so it crosses the 256k-line threshold) and check, after every step,
+//              that rescoreTop of a scorer kept across the steps returns exactly what scoreTop of the edited corpus returns. Steps add, replace or remove a document, pass the
+//              corpus unchanged or ask for a different number of lines (at times every line); enough documents are replaced for the removed slots to outnumber live ones and be compacted
+// Input :- Policy - scoring policy under test, name - label to print, steps - number of edits
+// Output :- Returns number of steps whose rankings differ
+// Sideeffect :- Allocates the corpus, writes a line to standard output and the first mismatches to standard error
+// Assumption :- None
+template <typename Policy>
+static std::size_t checkRescore(const char* name, std::size_t steps) {
+    std::mt19937 rng(11);
+    std::uint32_t nextRare = kCommonWords;
+    EditedCorpus edited;
+    for (int d = 0; d < 66; d++) {
+        edited.documents.push_back(makeDocument(rng, nextRare));
+        countDocument(edited, *edited.documents.back(), +1);
+    }
+
+    BasicLineScorer<Policy> incremental, full;
+    std::size_t failures = 0, limit = 40;
+    for (std::size_t step = 0; step < steps; step++) {
+        std::size_t at = rng() % edited.documents.size();
+        std::string edit;
+        // Replacements dominate so removed slots pile up; as many adds as removals keep the corpus between 60 and 72 documents
+        const std::uint32_t roll = rng() % 8;
+        if (roll <= 1 && edited.documents.size() < 72) {
+            edit = "add";
+            edited.documents.insert(edited.documents.begin() + at, makeDocument(rng, nextRare));
+            countDocument(edited, *edited.documents[at], +1);
+        } else if (roll <= 4) {
+            edit = "replace";
+            countDocument(edited, *edited.documents[at], -1);
+            edited.documents[at] = makeDocument(rng, nextRare);
+            countDocument(edited, *edited.documents[at], +1);
+        } else if (roll <= 6 && edited.documents.size() > 60) {
+            edit = "remove";
+            countDocument(edited, *edited.documents[at], -1);
+            edited.documents.erase(edited.documents.begin() + at);
+        } else if (rng() % 2 == 0) {
+            edit = "unchanged";
+        } else {
+            // A few lines, or every line so a stale score anywhere shows
+            edit = "limit";
+            limit = rng() % 3 == 0 ? kDocumentLines * 72 : std::size_t(1) << (rng() % 9);
+        }
+
+        Corpus corpus;
+        for (const auto& doc : edited.documents)
+            corpus.add(doc);
+        std::vector<ScoredRef> expected = full.scoreTop(corpus, edited.freq, limit);
+        std::vector<ScoredRef> actual = incremental.rescoreTop(corpus, edited.freq, limit);
+        if (!sameRanking(expected, actual)) {
+            if (failures < 5)
+                std::cerr << "rescoreTop " << name << " mismatch at step " << step << " (" << edit << ", " << corpus.size() << " lines, limit " << limit << ")\n";
+            failures++;
+        }
+    }
+    std::cout << "rescoreTop " << name << ": " << steps << " edits, "
+              << (failures == 0 ? "identical to scoreTop after each" : "MISMATCH") << "\n";
+    return failures;
+}
+
+// Objective :- Entry point of the incremental rescoring check run by "make test". Proves rescoreTop returns the same lines as a full scoreTop after every edit.
+// Input :- None
+// Output :- Returns 0 if every step matches, 1 otherwise
+// Sideeffect :- Writes results to the console
+int main() {
+    std::size_t failures = checkRescore<DensityPolicy>("density", 200) + checkRescore<Bm25Policy>("bm25", 40);
+    if (failures > 0) {
+        std::cerr << failures << " mismatch(es)\n";
+        return 1;
+    }
+    std::cout << "Incremental rescoring matches full scoring.\n";
+    return 0;
+}
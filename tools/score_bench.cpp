@@ -0,0 +1,191 @@
+#include "../include/corpus.h"
+#include "../include/line_scorer.h"
+#include "../include/parallel.h"
+#include "../include/simd.h"
+#include "../include/top_k.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Lines summed per simd::lineSums call, as in line_scorer.cpp
+static const std::size_t kScoreBlock = 256;
+
+// Objective :- Ranking of scored lines: higher score first, then earlier line
+// Input :- a, b - lines to compare
+// Output :- Returns true if a ranks before b
+// Sideeffect :- None
+// Assumption :- None
+static bool ranksBefore(const ScoredRef& a, const ScoredRef& b) {
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.index < b.index;
+}
+
+// Objective :- Score lines the way LineScorer::scoreTop did on one thread before the scoring formula became a policy: the density formula written into the loop
+// Input :- corpus - processed lines to score, keywordFreq - frequency of each token ID, limit - number of best lines to return
+// Output :- Returns references to the best 'limit' lines sorted by ranksBefore
+// Sideeffect :- Builds a normalized weight table
+// Assumption :- keywordFreq is not empty and not all zero
+static std::vector<ScoredRef> hardCodedTop(const Corpus& corpus, const std::vector<std::uint32_t>& keywordFreq, std::size_t limit) {
+    // Normalized weights with the zero sentinel
+    const double maxFreq = *std::max_element(keywordFreq.begin(), keywordFreq.end());
+    const std::uint32_t sentinel = static_cast<std::uint32_t>(keywordFreq.size());
+    std::vector<float> normalized(keywordFreq.size() + 1, 0.0f);
+    for (std::size_t id = 0; id < keywordFreq.size(); id++)
+        normalized[id] = static_cast<float>(keywordFreq[id] / maxFreq);
+
+    TopK<ScoredRef, bool (*)(const ScoredRef&, const ScoredRef&)> top(limit, ranksBefore);
+    float sums[kScoreBlock];
+    std::size_t base = 0;
+    for (const auto& doc : corpus.documents()) {
+        const TokenId* tokens = doc->tokenData();
+        const std::uint32_t* offsets = doc->tokenOffsets();
+        for (std::size_t first = 0; first < doc->size(); first += kScoreBlock) {
+            std::size_t count = std::min(kScoreBlock, doc->size() - first);
+            simd::lineSums(normalized.data(), sentinel, tokens, offsets + first, count, sums);
+            for (std::size_t j = 0; j < count; j++) {
+                std::size_t n = offsets[first + j + 1] - offsets[first + j];
+                if (n == 0)
+                    continue;
+                double density = sums[j] / static_cast<double>(n);
+                double lengthBonus = std::min(1.0, (double)n / 20.0);
+                top.push(ScoredRef{static_cast<std::uint32_t>(base + first + j), static_cast<float>(density * 0.8 + lengthBonus * 0.2)});
+            }
+        }
+        base += doc->size();
+    }
+    return top.take();
+}
+
+// Objective :- Time a scoring routine over the corpus, keeping the best of several runs
+// Input :- name - label to print, lines - number of lines scored, score - routine returning the best lines, seconds - optional pointer receiving the best time
+// Output :- Returns the best lines of the last run
+// Sideeffect :- Writes the best time and throughput to standard output
+// Assumption :- None
+template <typename Score>
+static std::vector<ScoredRef> timeScore(const char* name, std::size_t lines, Score&& score, double* seconds = nullptr) {
+    double best = 0.0;
+    std::vector<ScoredRef> result;
+    for (int run = 0; run < 5; run++) {
+        auto started = std::chrono::steady_clock::now();
+        result = score();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+    }
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << best * 1000.0 << " ms" << std::setw(10) << lines / best / 1e6 << " Mlines/s";
+    if (seconds)
+        *seconds = best;
+    else
+        std::cout << "\n";
+    std::cout << std::defaultfloat;
+    return result;
+}
+
+// Objective :- Compare two rankings reference by reference
+// Input :- a, b - rankings to compare
+// Output :- Returns true if both hold the same lines with the same scores in the same order
+// Sideeffect :- None
+// Assumption :- None
+static bool sameRanking(const std::vector<ScoredRef>& a, const std::vector<ScoredRef>& b) {
+    bool same = a.size() == b.size();
+    for (std::size_t i = 0; same && i < a.size(); i++)
+        same = a[i].index == b[i].index && a[i].score == b[i].score;
+    return same;
+}
+
+// Objective :- Time LineScorer::scoreTop on 1, 2, 4, 8 and all hardware threads, for the best 'limit' lines (one heap per task) and for every line (sorted runs merged in rounds),
+//              and check every thread count returns exactly the ranking of one thread
+// Input :- corpus - lines to score, freq - frequency of each token ID, limit - number of best lines
+// Output :- Returns true if every thread count ranks identically
+// Sideeffect :- Writes the best time and the speedup over one thread per thread count to standard output
+// Assumption :- None
+static bool threadSweep(const Corpus& corpus, const std::vector<std::uint32_t>& freq, std::size_t limit) {
+    std::vector<std::size_t> counts{1, 2, 4, 8};
+    std::size_t hardware = parallel::resolveThreads(0);
+    if (std::find(counts.begin(), counts.end(), hardware) == counts.end())
+        counts.push_back(hardware);
+
+    bool same = true;
+    for (std::size_t wanted : {limit, corpus.size()}) {
+        std::cout << "LineScorer::scoreTop of " << (wanted == corpus.size() ? std::string("every line") : "the best " + std::to_string(wanted))
+                  << " by thread count (hardware threads: " << hardware << ", best of 5):\n";
+        std::vector<ScoredRef> single;
+        double singleSeconds = 0.0;
+        for (std::size_t threads : counts) {
+            LineScorer scorer;
+            scorer.setThreads(threads);
+            double seconds = 0.0;
+            std::string name = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+            auto ranked = timeScore(name.c_str(), corpus.size(), [&]() { return scorer.scoreTop(corpus, freq, wanted); }, &seconds);
+            if (threads == 1) {
+                single = std::move(ranked);
+                singleSeconds = seconds;
+            } else if (!sameRanking(single, ranked)) {
+                same = false;
+                std::cout << "  (ranks DIFFERENTLY from 1 thread)";
+            }
+            std::cout << std::fixed << std::setprecision(2) << std::setw(8) << singleSeconds / seconds << "x\n" << std::defaultfloat;
+        }
+    }
+    std::cout << (same ? "Every thread count ranks identically to 1 thread.\n" : "Thread counts rank DIFFERENTLY!\n");
+    return same;
+}
+
+// Objective :- Entry point of the line scoring benchmark run by "make bench". Times the hard-coded density loop the scorers used to have against the policy scorers
+//              (density, BM25, TF-IDF sum) on one thread, checks the density policy ranks exactly as the hard-coded loop, then times scoring by thread count and checks
+//              every thread count ranks identically
+// Input :- argv[1] - optional number of lines in millions (default 5)
+// Output :- Returns 0, or 1 if the density policy or a thread count ranks differently
+// Sideeffect :- Allocates the corpus, writes timings to the console
+int main(int argc, char* argv[]) {
+    // Lines of 1-24 tokens with Zipf-distributed IDs over a 200k-word vocabulary, in documents of 50k lines
+    const std::size_t lines = (argc > 1 ? std::stoul(argv[1]) : 5) * 1000000;
+    const std::uint32_t vocabulary = 200000;
+    const std::size_t documentLines = 50000, limit = 40;
+    std::mt19937 rng(3);
+    std::vector<double> cumulative(vocabulary);
+    double total = 0.0;
+    for (std::uint32_t id = 0; id < vocabulary; id++)
+        cumulative[id] = total += 1.0 / (id + 1);
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    Corpus corpus;
+    std::vector<std::uint32_t> freq(vocabulary, 0);
+    for (std::size_t first = 0; first < lines; first += documentLines) {
+        std::vector<ProcessedLine> docLines(std::min(documentLines, lines - first));
+        for (auto& line : docLines) {
+            std::uint32_t length = 1 + rng() % 24;
+            for (std::uint32_t i = 0; i < length; i++) {
+                TokenId id = static_cast<TokenId>(std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin());
+                line.tokens.push_back(id);
+                freq[id]++;
+            }
+        }
+        corpus.add(std::make_shared<const DocumentArena>(docLines));
+    }
+
+    std::cout << "Line scoring over " << lines << " lines, best " << limit << ", 1 thread (best of 5):\n";
+    auto hardCoded = timeScore("hard-coded density loop", lines, [&]() { return hardCodedTop(corpus, freq, limit); });
+    LineScorer density;
+    auto byPolicy = timeScore("DensityPolicy", lines, [&]() { return density.scoreTop(corpus, freq, limit); });
+    Bm25LineScorer bm25;
+    timeScore("Bm25Policy", lines, [&]() { return bm25.scoreTop(corpus, freq, limit); });
+    TfidfSumLineScorer sum;
+    timeScore("TfidfSumPolicy", lines, [&]() { return sum.scoreTop(corpus, freq, limit); });
+
+    // The policy must not change what the density formula ranks
+    bool same = sameRanking(hardCoded, byPolicy);
+    std::cout << (same ? "DensityPolicy ranks identically to the hard-coded loop.\n" : "DensityPolicy ranks DIFFERENTLY from the hard-coded loop!\n");
+
+    // Nor may the number of threads
+    bool deterministic = threadSweep(corpus, freq, limit);
+    return same && deterministic ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#include "../include/simd.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Objective :- Normalize text the way Preprocessor::normalize did before the SIMD kernels, one std::isalnum/std::isspace/std::tolower call per byte
+// Input :- in - source bytes, n - number of bytes, out - destination with room for n bytes
+// Output :- None (void function)
+// Sideeffect :- Writes n bytes to out
+// Assumption :- The "C" locale is active (the program never changes it)
+static void normalizeReference(const char* in, std::size_t n, char* out) {
+    for (std::size_t i = 0; i < n; i++) {
+        unsigned char ch = static_cast<unsigned char>(in[i]);
+        out[i] = (std::isalnum(ch) || std::isspace(ch)) ? static_cast<char>(std::tolower(ch)) : ' ';
+    }
+}
+
+// Objective :- Time a normalization routine over a text, keeping the best of several runs
+// Input :- name - label to print, text - input, out - output buffer of the same size, normalize - routine to time
+// Output :- None (void function)
+// Sideeffect :- Writes the best time and throughput to standard output
+// Assumption :- out.size() == text.size()
+template <typename Normalize>
+static void timeNormalize(const char* name, const std::string& text, std::string& out, Normalize&& normalize) {
+    double best = 0.0;
+    for (int run = 0; run < 5; run++) {
+        auto started = std::chrono::steady_clock::now();
+        normalize(text.data(), text.size(), &out[0]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        if (run == 0 || seconds < best)
+            best = seconds;
+    }
+    double megabytes = text.size() / (1024.0 * 1024.0);
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << best * 1000.0 << " ms" << std::setw(10) << megabytes / best << " MB/s\n"
+              << std::defaultfloat;
+}
+
+// Objective :- Time each runnable lineSums kernel over a token column shaped like a real corpus: 1M lines of 1-24 tokens (about 12.5M tokens) with Zipf-distributed IDs over a
+//              200k-word vocabulary, summed in blocks of 256 lines the way the line scorers call it
+// Input :- None
+// Output :- None (void function)
+// Sideeffect :- Allocates about 60 MB, writes the best of 5 times and throughput to standard output
+// Assumption :- None
+static void benchLineSums() {
+    const std::uint32_t vocabulary = 200000;
+    const std::size_t lines = 1000000, block = 256;
+    std::mt19937 rng(2);
+
+    // Zipf(1) IDs by inverting the cumulative harmonic weight; about 1 in 50 tokens are past the table (words only in the other documents)
+    std::vector<double> cumulative(vocabulary);
+    double total = 0.0;
+    for (std::uint32_t id = 0; id < vocabulary; id++)
+        cumulative[id] = total += 1.0 / (id + 1);
+    std::vector<float> weights(vocabulary + 1);
+    for (std::uint32_t id = 0; id < vocabulary; id++)
+        weights[id] = static_cast<float>(std::log1p(id));
+    weights[vocabulary] = 0.0f;
+    std::vector<std::uint32_t> ids, offsets{0};
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    for (std::size_t line = 0; line < lines; line++) {
+        std::uint32_t length = 1 + rng() % 24;
+        for (std::uint32_t i = 0; i < length; i++)
+            ids.push_back(rng() % 50 == 0 ? vocabulary + 1
+                                          : static_cast<std::uint32_t>(std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) -
+                                                                       cumulative.begin()));
+        offsets.push_back(static_cast<std::uint32_t>(ids.size()));
+    }
+    std::vector<float> sums(lines);
+
+    std::cout << "lineSums over " << std::setprecision(3) << ids.size() / 1000000.0 << "M tokens in " << lines << " lines (best of 5):\n";
+    for (simd::Kernel kernel : {simd::Kernel::Scalar, simd::Kernel::Avx2}) {
+        if (!simd::supports(kernel))
+            continue;
+        double best = 0.0;
+        for (int run = 0; run < 5; run++) {
+            auto started = std::chrono::steady_clock::now();
+            for (std::size_t first = 0; first < lines; first += block)
+                simd::lineSums(kernel, weights.data(), vocabulary, ids.data(), offsets.data() + first,
+                               std::min(block, lines - first), sums.data() + first);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            if (run == 0 || seconds < best)
+                best = seconds;
+        }
+        std::cout << "  " << std::left << std::setw(28) << (kernel == simd::Kernel::Avx2 ? "avx2 gather" : "scalar loop") << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(9) << best * 1000.0 << " ms" << std::setw(10)
+                  << ids.size() / best / 1e6 << " Mtok/s\n"
+                  << std::defaultfloat;
+    }
+}
+
+// Objective :- Entry point of the kernel micro-benchmark run by "make bench". Times each runnable normalizeAscii kernel against the per-byte isalnum/isspace/tolower loop it
+//              replaced, and the lineSums gather kernel against the scalar loop
+// Input :- argv[1] - optional text size in MB (default 64)
+// Output :- Returns 0
+// Sideeffect :- Allocates the text, writes timings to the console
+int main(int argc, char* argv[]) {
+    // Prose-like text: mostly letters and spaces, some capitals, digits and punctuation
+    std::size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 64;
+    std::string text(megabytes << 20, ' ');
+    std::mt19937 rng(1);
+    const std::string alphabet = "abcdefghijklmnopqrstuvwxyz     ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.,;:()-'\"\n";
+    for (char& c : text)
+        c = alphabet[rng() % alphabet.size()];
+    std::string out(text.size(), '\0');
+
+    std::cout << "normalizeAscii over " << megabytes << " MB (best of 5):\n";
+    timeNormalize("isalnum/isspace/tolower", text, out, normalizeReference);
+    for (simd::Kernel kernel : {simd::Kernel::Scalar, simd::Kernel::Sse2, simd::Kernel::Avx2}) {
+        if (!simd::supports(kernel))
+            continue;
+        const char* name = kernel == simd::Kernel::Avx2 ? "avx2" : kernel == simd::Kernel::Sse2 ? "sse2" : "scalar table";
+        timeNormalize(name, text, out, [kernel](const char* in, std::size_t n, char* o) { simd::normalizeAscii(kernel, in, n, o); });
+    }
+    benchLineSums();
+    return 0;
+}
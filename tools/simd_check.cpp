@@ -0,0 +1,191 @@
+#include "../include/simd.h"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Objective :- Normalize text the way Preprocessor::normalize did before the SIMD kernels, one std::isalnum/std::isspace/std::tolower call per byte
+// Input :- in - source bytes, n - number of bytes, out - destination with room for n bytes
+// Output :- None (void function)
+// Sideeffect :- Writes n bytes to out
+// Assumption :- The "C" locale is active (the program never changes it)
+static void normalizeReference(const char* in, std::size_t n, char* out) {
+    for (std::size_t i = 0; i < n; i++) {
+        unsigned char ch = static_cast<unsigned char>(in[i]);
+        out[i] = (std::isalnum(ch) || std::isspace(ch)) ? static_cast<char>(std::tolower(ch)) : ' ';
+    }
+}
+
+// Objective :- Report the name of a kernel family
+// Input :- kernel - kernel family
+// Output :- Returns a short name
+// Sideeffect :- None
+// Assumption :- None
+static const char* kernelName(simd::Kernel kernel) {
+    switch (kernel) {
+    case simd::Kernel::Sse2:
+        return "sse2";
+    case simd::Kernel::Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+// Objective :- Check every runnable normalizeAscii kernel against the reference: every byte value at every position of every length and start alignment from 0 to 64
+//              (covering the scalar tail and each vector width), in place and out of place, plus one long random run
+// Input :- None
+// Output :- Returns number of mismatches found
+// Sideeffect :- Writes a line per kernel to standard output and the first mismatches to standard error
+// Assumption :- None
+static std::size_t checkNormalize() {
+    const std::size_t kMaxLength = 64, kMaxStart = 64;
+    std::size_t failures = 0;
+    for (simd::Kernel kernel : {simd::Kernel::Scalar, simd::Kernel::Sse2, simd::Kernel::Avx2}) {
+        if (!simd::supports(kernel)) {
+            std::cout << "normalizeAscii " << kernelName(kernel) << ": not supported here, skipped\n";
+            continue;
+        }
+        std::size_t cases = 0, before = failures;
+        // 64-byte aligned source so 'start' is the alignment of the input
+        alignas(64) char source[kMaxStart + kMaxLength];
+        alignas(64) char expected[kMaxLength], actual[kMaxLength], inPlace[kMaxStart + kMaxLength];
+        // Rotating the byte pattern puts every byte value at every offset of every window
+        for (int rotation = 0; rotation < 256; rotation++) {
+            for (std::size_t j = 0; j < sizeof(source); j++)
+                source[j] = static_cast<char>((rotation + j) & 0xFF);
+            for (std::size_t start = 0; start <= kMaxStart; start++)
+                for (std::size_t length = 0; length <= kMaxLength; length++) {
+                    normalizeReference(source + start, length, expected);
+                    simd::normalizeAscii(kernel, source + start, length, actual);
+                    std::copy(source, source + sizeof(source), inPlace);
+                    simd::normalizeAscii(kernel, inPlace + start, length, inPlace + start);
+                    cases++;
+                    if (std::string(expected, length) != std::string(actual, length) ||
+                        std::string(expected, length) != std::string(inPlace + start, length)) {
+                        if (failures - before < 5)
+                            std::cerr << "normalizeAscii " << kernelName(kernel) << " mismatch: rotation " << rotation
+                                      << ", start " << start << ", length " << length << "\n";
+                        failures++;
+                    }
+                }
+        }
+        // One long random run through many full vector steps
+        std::mt19937 rng(42);
+        std::vector<char> text(1 << 20), reference(text.size()), result(text.size());
+        for (char& c : text)
+            c = static_cast<char>(rng() & 0xFF);
+        normalizeReference(text.data(), text.size(), reference.data());
+        simd::normalizeAscii(kernel, text.data(), text.size(), result.data());
+        cases++;
+        if (reference != result) {
+            std::cerr << "normalizeAscii " << kernelName(kernel) << " mismatch on the 1 MB random run\n";
+            failures++;
+        }
+        std::cout << "normalizeAscii " << kernelName(kernel) << ": " << cases << " cases, "
+                  << (failures == before ? "identical to isalnum/isspace/tolower" : "MISMATCH") << "\n";
+    }
+    return failures;
+}
+
+// Objective :- Check every runnable lineSums kernel against a double-precision sum: every line length from 0 to 64 (full groups of 8 and every masked tail) at every start
+//              alignment of the token column from 0 to 7, with IDs past the table clamped to its sentinel, plus one block of 100k random lines
+// Input :- None
+// Output :- Returns number of sums outside float rounding of the reference
+// Sideeffect :- Writes a line per kernel to standard output and the first mismatches to standard error
+// Assumption :- None
+static std::size_t checkLineSums() {
+    const std::uint32_t limit = 5000;
+    std::mt19937 rng(7);
+    // Weight table with its zero sentinel
+    std::vector<float> weights(limit + 1);
+    for (std::uint32_t id = 0; id < limit; id++)
+        weights[id] = std::uniform_real_distribution<float>(0.0f, 1.0f)(rng);
+    weights[limit] = 0.0f;
+
+    // Objective :- Draw a token ID, one in ten past the table (the sentinel itself, just past it, or far past it)
+    auto drawId = [&]() -> std::uint32_t {
+        std::uint32_t r = rng();
+        if (r % 10 != 0)
+            return r % limit;
+        const std::uint32_t past[] = {limit, limit + 1, 0x7FFFFFFFu, 0xFFFFFFFFu};
+        return past[(r / 10) % 4];
+    };
+
+    // Cases: one line per (start, length), then a block of random lines
+    std::vector<std::uint32_t> ids, offsets{0};
+    for (std::uint32_t start = 0; start < 8; start++)
+        for (std::uint32_t length = 0; length <= 64; length++) {
+            // Pad so the line's first token sits 'start' IDs past a multiple of 8
+            while (ids.size() % 8 != start)
+                ids.push_back(drawId());
+            offsets.back() = static_cast<std::uint32_t>(ids.size());
+            for (std::uint32_t i = 0; i < length; i++)
+                ids.push_back(drawId());
+            offsets.push_back(static_cast<std::uint32_t>(ids.size()));
+        }
+    for (int line = 0; line < 100000; line++) {
+        std::uint32_t length = rng() % 40;
+        for (std::uint32_t i = 0; i < length; i++)
+            ids.push_back(drawId());
+        offsets.push_back(static_cast<std::uint32_t>(ids.size()));
+    }
+    const std::size_t lines = offsets.size() - 1;
+
+    // Reference sums in double precision, with the bound float rounding can reach
+    std::vector<double> reference(lines), bound(lines);
+    for (std::size_t l = 0; l < lines; l++) {
+        double sum = 0.0;
+        for (std::uint32_t i = offsets[l]; i < offsets[l + 1]; i++)
+            sum += weights[std::min(ids[i], limit)];
+        reference[l] = sum;
+        bound[l] = (offsets[l + 1] - offsets[l] + 1) * FLT_EPSILON * sum;
+    }
+
+    std::size_t failures = 0;
+    std::vector<float> scalar(lines);
+    simd::lineSums(simd::Kernel::Scalar, weights.data(), limit, ids.data(), offsets.data(), lines, scalar.data());
+    for (simd::Kernel kernel : {simd::Kernel::Scalar, simd::Kernel::Avx2}) {
+        if (!simd::supports(kernel)) {
+            std::cout << "lineSums " << kernelName(kernel) << ": not supported here, skipped\n";
+            continue;
+        }
+        std::size_t before = failures;
+        std::vector<float> sums(lines, -1.0f);
+        simd::lineSums(kernel, weights.data(), limit, ids.data(), offsets.data(), lines, sums.data());
+        for (std::size_t l = 0; l < lines; l++) {
+            // Within rounding of the exact sum and of the scalar kernel; empty lines and lines of only unknown IDs are exactly 0
+            bool ok = std::fabs(sums[l] - reference[l]) <= bound[l] && std::fabs(sums[l] - scalar[l]) <= 2 * bound[l] &&
+                      (reference[l] != 0.0 || sums[l] == 0.0f);
+            if (!ok) {
+                if (failures - before < 5)
+                    std::cerr << "lineSums " << kernelName(kernel) << " mismatch: line " << l << " (" << offsets[l + 1] - offsets[l]
+                              << " tokens from offset " << offsets[l] << "): " << sums[l] << " vs " << reference[l] << "\n";
+                failures++;
+            }
+        }
+        std::cout << "lineSums " << kernelName(kernel) << ": " << lines << " lines, "
+                  << (failures == before ? "within float rounding of the exact sums" : "MISMATCH") << "\n";
+    }
+    return failures;
+}
+
+// Objective :- Entry point of the kernel equivalence check run by "make test". Proves the SIMD kernels produce the same output as the portable code they replace.
+// Input :- None
+// Output :- Returns 0 if every kernel matches, 1 otherwise
+// Sideeffect :- Writes results to the console
+int main() {
+    std::size_t failures = checkNormalize() + checkLineSums();
+    if (failures > 0) {
+        std::cerr << failures << " mismatch(es)\n";
+        return 1;
+    }
+    std::cout << "All kernels match.\n";
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "../include/stopword_table.h"
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Built-in English stopwords, as listed in stopword_table.cpp
+static const char* const kBuiltIn[] = {
+    "a", "an", "the", "and", "or", "but", "if", "then", "else", "for", "with",
+    "about", "into", "onto", "from", "that", "this", "those", "these", "to", "of",
+    "in", "on", "at", "as", "by", "it", "is", "are", "was", "were", "be", "been",
+    "being", "so", "we", "you", "they", "he", "she", "them", "their", "there",
+    "here", "can", "could", "should", "would", "may", "might", "will", "just",
+    "than", "also", "such", "not", "no", "do", "does", "did", "done", "its"};
+
+// Stopword file written and removed by the check, in the working directory
+static const char* kListPath = "stopword_check.tmp";
+
+// Objective :- Draw a random normalized token: 1-10 lowercase letters or digits
+// Input :- rng - random source
+// Output :- Returns the token
+// Sideeffect :- Advances rng
+// Assumption :- None
+static std::string randomWord(std::mt19937& rng) {
+    static const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    std::string word(1 + rng() % 10, 'a');
+    for (char& c : word)
+        c = kAlphabet[rng() % 36];
+    return word;
+}
+
+// Objective :- Compare a table with the expected set: every expected word, near misses of them (one letter longer, one shorter) and random probes
+// Input :- name - label for messages, table - table under test, expected - words it must hold, rng - random source, probes - number of random probes
+// Output :- Returns number of mismatches found
+// Sideeffect :- Writes the first mismatches to standard error
+// Assumption :- None
+static std::size_t compare(const char* name, const StopwordTable& table, const std::set<std::string>& expected, std::mt19937& rng, std::size_t probes) {
+    std::size_t failures = 0;
+    auto check = [&](const std::string& token) {
+        if (table.contains(token) != (expected.count(token) == 1)) {
+            if (failures < 5)
+                std::cerr << "StopwordTable " << name << " mismatch for \"" << token << "\"\n";
+            failures++;
+        }
+    };
+    for (const std::string& word : expected) {
+        check(word);
+        check(word + "s");
+        check(word.substr(0, word.size() - 1));
+    }
+    for (std::size_t i = 0; i < probes; i++)
+        check(randomWord(rng));
+    check("");
+    if (table.size() != expected.size()) {
+        std::cerr << "StopwordTable " << name << " holds " << table.size() << " words, expected " << expected.size() << "\n";
+        failures++;
+    }
+    std::cout << "StopwordTable " << name << ": " << expected.size() << " words, " << probes << " random probes, "
+              << (failures == 0 ? "identical to std::set" : "MISMATCH") << "\n";
+    return failures;
+}
+
+// Objective :- Entry point of the stopword table check run by "make test". Loads a 20,000-word stopword file (several words per line, comment lines, capitals and punctuation
+//              that normalization must split) and checks membership against std::set, then loads a second file on top and checks a missing file leaves the table as it was
+// Input :- None
+// Output :- Returns 0 if every lookup matches, 1 otherwise
+// Sideeffect :- Writes and removes a file in the working directory, writes results to the console
+int main() {
+    std::mt19937 rng(29);
+    std::set<std::string> expected(std::begin(kBuiltIn), std::end(kBuiltIn));
+    std::size_t failures = compare("built-in", StopwordTable(), expected, rng, 200000);
+
+    // Lines of 1-8 words; every tenth line is a comment whose words must not be loaded
+    auto writeList = [&](std::size_t count) {
+        std::ofstream list(kListPath, std::ios::binary);
+        std::size_t written = 0;
+        while (written < count) {
+            if (rng() % 10 == 0) {
+                list << "# comment commentonlyword" << rng() % 100 << "\n";
+                continue;
+            }
+            std::size_t perLine = 1 + rng() % 8;
+            for (std::size_t i = 0; i < perLine && written < count; i++, written++) {
+                std::string word = randomWord(rng);
+                expected.insert(word);
+                // Some words written in capitals, some glued to the next by punctuation (normalization lowercases and splits them)
+                if (rng() % 8 == 0)
+                    for (char& c : word)
+                        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                list << word << (rng() % 8 == 0 ? "-" : rng() % 2 ? " " : "\t");
+            }
+            list << (rng() % 2 ? "\n" : " \r\n");
+        }
+    };
+
+    StopwordTable table;
+    writeList(20000);
+    if (!table.loadFile(kListPath)) {
+        std::cerr << "Cannot load " << kListPath << "\n";
+        failures++;
+    }
+    failures += compare("with 20000 loaded words", table, expected, rng, 200000);
+
+    // A second file adds to the first
+    writeList(5000);
+    if (!table.loadFile(kListPath)) {
+        std::cerr << "Cannot load " << kListPath << " again\n";
+        failures++;
+    }
+    std::remove(kListPath);
+    failures += compare("with a second file", table, expected, rng, 200000);
+
+    // A missing file fails and changes nothing
+    std::cout << "Loading a missing file (an error message is expected):\n";
+    if (table.loadFile(kListPath)) {
+        std::cerr << "Loading a missing file succeeded\n";
+        failures++;
+    }
+    failures += compare("after a failed load", table, expected, rng, 20000);
+
+    if (failures > 0) {
+        std::cerr << failures << " mismatch(es)\n";
+        return 1;
+    }
+    std::cout << "StopwordTable matches std::set.\n";
+    return 0;
+}